@@ -37,12 +37,19 @@ typedef enum {
     AUTO
 } CacheMode;
 
+typedef enum {
+    DEPTH_REPLACE,
+    WORK_REPLACE
+} ReplacePolicy;
+
 typedef struct {
     Solver solver;
     int depth;
     double timeLimit;
     bool clip;
     CacheMode compressCache;
+    bool unifiedCache;
+    ReplacePolicy replacePolicy;
     bool progressBar;
     bool useOpeningBook;
 } SolverConfig;
@@ -107,6 +114,7 @@ typedef struct {
     uint64_t exactCount;
     uint64_t lowerCount;
     uint64_t upperCount;
+    uint64_t windowCount;
 
     // Depth Stats
     uint64_t solvedEntries;
@@ -124,6 +132,22 @@ typedef struct {
     uint64_t failStones;
     uint64_t failRange;
 
+    // Rehash (last resize or mode switch)
+    uint64_t rehashed;
+    uint64_t rehashDropped;
+
+    // Solved table (0 size if disabled)
+    uint64_t solvedTableSize;
+    uint64_t solvedTableEntries;
+    uint64_t solvedTableHits;
+    uint64_t solvedTableSpills;
+
+    // Leaf table (0 size if disabled)
+    uint64_t leafTableSize;
+    uint64_t leafTableEntries;
+    uint64_t leafTableHits;
+    uint64_t leafTableStores;
+
     // Board Visualization Data (Arrays of 14)
     double avgStones[14];
     double maxStones[14];
@@ -0,0 +1,29 @@
+#pragma once
+
+/**
+ * Copyright (c) Alexander Kurtz 2026
+ */
+
+/**
+ * Memory budget:
+ * One RAM budget shared by the opening book, the EGDB layers and the transposition table.
+ * The book is fixed, the exact and then the WDL layers of the EGDB may take up to half of the rest
+ * and the cache gets what is left, sized with the entry bytes of the layout the next search will
+ * use. The budget is capped below the installed RAM so the tables never push the machine into swap.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "containers.h"
+
+// Share of the installed RAM the budget may use, the rest is left to the system
+#define MEMORY_BUDGET_RAM_SHARE 0.75
+
+// Bytes for book, EGDB and cache together, 0 leaves the sizes to the user
+void setMemoryBudget(uint64_t bytes);
+uint64_t getMemoryBudget();
+
+// Trims EGDB and WDL layers that do not fit and sets cache size and compression for the next search
+// Trims are always reported, report adds the full plan
+void applyMemoryBudget(SolverConfig *config, bool report);
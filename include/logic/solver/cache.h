@@ -28,6 +28,7 @@
 #include "user/render.h"
 
 #define DEFAULT_CACHES_SIZE 24
+#define MIN_CACHE_SIZE 17
 
 // <<-- PACKED BOUND + VAL -->>
 #define CACHE_VAL_UNSET INT16_MAX
@@ -35,25 +36,73 @@
 #define CACHE_VAL_MIN ((INT16_MIN >> 2) + 2)
 #define CACHE_VAL_MAX (INT16_MAX >> 2)
 
+// <<-- PACKED LOWER + UPPER (No Depth) -->>
+#define CACHE_BOUND_NEG_INF INT8_MIN
+#define CACHE_BOUND_POS_INF INT8_MAX
+#define CACHE_BOUND_MIN (INT8_MIN + 1)
+#define CACHE_BOUND_MAX (INT8_MAX - 1)
+
+// Lower bound +inf, upper bound -inf
+#define CACHE_BOUNDS_UNSET ((int16_t)(INT16_MIN | INT8_MAX))
+
+// Reported by a probe for a side without a bound
+#define CACHE_NO_LOWER INT32_MIN
+#define CACHE_NO_UPPER INT32_MAX
+
 #define EXACT_BOUND 0
 #define LOWER_BOUND 1
 #define UPPER_BOUND 2
 
 #define DEPTH_SOLVED UINT16_MAX
 
+// <<-- PACKED DEPTH + WORK (Depth) -->>
+#define ENTRY_DEPTH_SOLVED 0x0FFF
+#define ENTRY_DEPTH_MAX (ENTRY_DEPTH_SOLVED - 1)
+#define ENTRY_WORK_MAX 0x0F
+
+// Smallest cache that fits the clip layout, its 48-bit keys need a tag of at most 20 bits
+#define CLIP_TABLE_MIN_POW 29
+
+#define SOLVED_TABLE_MIN_POW 16
+#define SOLVED_TABLE_MAX_POW 36
+
+#define LEAF_TABLE_MIN_POW 13
+#define LEAF_TABLE_MAX_POW 24
+
+// Nodes that are routed to the leaf table: remaining depth (depth layouts only) or stones left in the pits
+#define LEAF_TABLE_DEPTH 2
+#define LEAF_TABLE_STONES 4
+
 // Does not allocate yet
 void setCacheSize(int sizePow);
 
+// Largest cache size whose table, together with the solved and leaf tables, fits the budget
+// Picks the compression giving the most entries and returns 0 if not even 2^MIN_CACHE_SIZE fits
+int planCacheSize(uint64_t budgetBytes, const SolverConfig *config, CacheMode *compressMode, uint64_t *tableBytes);
+
 // Enable / Disable depth storing (needed for non solving) and can enable 48 bit board representations
-void setCacheMode(bool depth, CacheMode compressMode);
+// With unifiedCache a depth table is kept for no-depth searches, which only use its solved entries
+// The work replacement policy always uses a depth layout, its scores share the depth field
+// With the clip layout enabled, clip solves use a 4-byte layout with narrow bounds once the cache is at least 2^CLIP_TABLE_MIN_POW
+void setCacheMode(bool depth, const SolverConfig *config);
+
+// Off by default, it is denser but slower; takes effect on the next setCacheMode
+void setClipLayout(bool enabled);
+bool getClipLayout();
 
 void invalidateCache();
 
 bool translateBoard(Board *board, uint64_t *code);
 
-void cacheNodeHash(Board *board, uint64_t boardRep, int evaluation, int boundType, int depth, bool solved);
+// Sees every key the solver probes or stores before the tables do, NULL removes it
+typedef void (*CacheTraceHook)(uint64_t key, bool store);
+void setCacheTraceHook(CacheTraceHook hook);
+
+// Work is the node count of the subtree behind the result, used by the work replacement policy
+void cacheNodeHash(Board *board, uint64_t boardRep, int evaluation, int boundType, int depth, bool solved, uint64_t work);
 
-bool getCachedValueHash(Board *board, uint64_t hashValue, int currentDepth, int *eval, int *boundType, bool *solved);
+// Reports the known window of the position, lower == upper for exact values
+bool getCachedValueHash(Board *board, uint64_t hashValue, int currentDepth, int *lower, int *upper, bool *solved);
 
 void fillCacheStats(CacheStats *stats, bool calcFrag, bool calcStoneDist, bool calcDepthDist);
 void renderCacheStats(bool calcFrag, bool calcStoneDist, bool calcDepthDist);
@@ -63,3 +112,16 @@ void resetCacheStats();
 void stepCache();
 
 uint64_t getCacheSize();
+
+// Separate table for solved results while the main table is in depth mode, 0 disables it
+// Allocates right away and keeps the entries of a previous table
+bool setSolvedTableSize(int sizePow);
+uint64_t getSolvedTableSize();
+
+// Small table for nodes near the horizon or with few stones left, off unless configured, 0 disables it
+bool setLeafTableSize(int sizePow);
+uint64_t getLeafTableSize();
+
+// Solved results are score independent, so they stay valid across games with the same move function
+bool saveSolvedTable(const char *path);
+bool loadSolvedTable(const char *path);
@@ -0,0 +1,108 @@
+/**
+ * Copyright (c) Alexander Kurtz 2026
+ */
+
+#pragma once
+
+/**
+ * Block cache:
+ * Decompressed blocks of the compressing backends are kept in a set associative cache, so hot
+ * blocks near the leaves are decoded once instead of on every probe. Blocks hash to one of
+ * EGDB_CACHE_SHARDS shards. Stores take the lock of their shard, hits take no lock: every set
+ * has a sequence counter that stores make odd while they rewrite it, and a lookup that saw it
+ * change counts as a miss. Hits only mark their way as used, stores evict the first way without
+ * that mark (second chance). Misses decode outside of any lock.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+// Uncompressed bytes per block, shared by all backends that compress in blocks
+#define EGDB_CACHE_BLOCK_SIZE 1024
+
+// Default memory of the decompressed blocks, split into 64 shards of 4-way sets
+#define EGDB_CACHE_DEFAULT_BYTES ((uint64_t)64 << 20)
+#define EGDB_CACHE_SHARDS 64
+#define EGDB_CACHE_WAYS 4
+
+// Allocates the configured size, runs without the cache if its memory can't be allocated
+void initBlockCache();
+
+// 0 disables the cache, a live cache is reallocated empty; only call while no probes run
+bool setBlockCacheBytes(uint64_t bytes);
+uint64_t getBlockCacheBytes();
+
+// Drops the blocks of a layer whose data is replaced or freed
+void invalidateBlockCache(int s);
+
+// Reads the offsets of one block if it is cached, counts a miss otherwise
+bool readCachedBlock(int s, uint64_t chunk_id, const uint64_t *offsets, int count, int8_t *vals);
+
+void storeCachedBlock(int s, uint64_t chunk_id, const int8_t *block);
+
+/**
+ * Block layers:
+ * The LZ4 and zstd backends store a layer as independently compressed blocks of
+ * EGDB_CACHE_BLOCK_SIZE values, so a probe decodes a single block. Their files start with a
+ * backend header that ends 8 byte aligned, followed by
+ *   offsets     chunk count + 1 offsets into the payload
+ *   payload     the compressed blocks
+ *   summaries   smallest and largest value of every block and a hash of them, missing in files
+ *               written before them
+ * Summaries without a matching hash are dropped, the backends then rebuild the file from the .bin
+ * if there is one. A layer either owns its buffers or points into a read-only shared mapping of
+ * its file. Loading a mapped layer costs no reads, pages come in on the first probe of their
+ * blocks and the page cache serves every process that maps the same file.
+ */
+
+typedef struct {
+    bool compressed;
+    uint8_t *data;
+    uint64_t *offsets;
+    uint64_t bytes;
+    uint64_t chunks;
+
+    // Two values per block for bound probes, NULL without summaries
+    int8_t *bounds;
+
+    // Dictionary the blocks are compressed against, only used by zstd
+    uint8_t *dict;
+    uint64_t dict_size;
+
+    // Set for layers mapped from their file, which owns all of the above
+    uint8_t *map;
+    uint64_t map_size;
+} EGDBBlockLayer;
+
+// Compressed size of one block, 0 on failure
+typedef uint64_t (*EGDBBlockEncoder)(void *context, const int8_t *src, uint64_t bytes, uint8_t *dst, uint64_t capacity);
+
+// Decodes one whole block, the last block of a layer may be shorter
+typedef bool (*EGDBBlockDecoder)(int s, const uint8_t *src, uint64_t bytes, int8_t *block);
+
+static inline uint64_t blockLayerChunks(uint64_t size) {
+    return (size + EGDB_CACHE_BLOCK_SIZE - 1) / EGDB_CACHE_BLOCK_SIZE;
+}
+
+// Frees or unmaps everything of the layer and drops its cached blocks
+void releaseBlockLayer(EGDBBlockLayer *layer, int s);
+
+// Fills an empty layer, the dictionary may already be set; bound is the worst case size of a block
+bool compressBlockLayer(EGDBBlockLayer *layer, const int8_t *raw_data, uint64_t size, uint64_t bound, EGDBBlockEncoder encode, void *context);
+
+// Points the layer into a mapped file whose header ends at offsets_start, false if the sections don't fit the file
+bool attachBlockFile(EGDBBlockLayer *layer, uint8_t *base, uint64_t file_size, uint64_t offsets_start, uint64_t chunks);
+
+// Writes the sections after the backend header
+bool writeBlockSections(FILE *f, const EGDBBlockLayer *layer);
+
+// Replaces the own buffers by the mapping map() creates of the file just written, keeps them if that fails
+bool adoptBlockFile(EGDBBlockLayer *layer, int s, uint64_t size, bool is_avalanche, bool (*map)(int s, uint64_t size, bool is_avalanche));
+
+bool probeBlockLayer(const EGDBBlockLayer *layer, int s, uint64_t idx, int8_t *val, EGDBBlockDecoder decode);
+bool probeBlockLayerBound(const EGDBBlockLayer *layer, uint64_t idx, int8_t *lower, int8_t *upper);
+bool probeBlockLayerBatch(const EGDBBlockLayer *layer, int s, const uint64_t *idx, int8_t *vals, int count, EGDBBlockDecoder decode);
+
+// Memory of the layer as used for the EGDB size statistics
+uint64_t blockLayerBytes(const EGDBBlockLayer *layer);
@@ -0,0 +1,36 @@
+/**
+ * Copyright (c) Alexander Kurtz 2026
+ */
+
+#pragma once
+
+/**
+ * File helpers shared by the EGDB container and the memory backends.
+ *
+ * Checkpoints of backends that generate a layer in a plain malloc'd table:
+ * The table is written to EGDB/egdb_N.bin.tmp.part and renamed over EGDB/egdb_N.bin.tmp, so the
+ * previous checkpoint stays intact until the new one is complete. Resume reads it back into a new
+ * table. The MMAP backend generates inside the .tmp file itself and keeps its own path.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Word wise multiply-rotate hash, each step is a bijection so a single changed word always shows
+uint64_t egdbHashBytes(const void *data, uint64_t size);
+
+// Writes a single buffer through writeFileReplacing
+bool egdbWriteFile(const char *path, const void *data, uint64_t size);
+
+#if !defined(_WIN32) && !defined(WEB_BUILD)
+// Maps a whole file read-only and shared, NULL if it is shorter than min_size or can't be mapped
+uint8_t *egdbMapFile(const char *path, uint64_t min_size, uint64_t *file_size);
+#endif
+
+// Writes egdb_tables[s] as EGDB/egdb_N.bin and removes the page summaries the MMAP backend kept of the old one
+bool egdbPlainSave(int s, uint64_t size, bool is_avalanche);
+
+bool egdbPlainCheckpoint(int s, uint64_t size, bool is_avalanche);
+
+// Allocates egdb_tables[s] from the checkpoint, false if it is missing or short
+bool egdbPlainResume(int s, uint64_t size, bool is_avalanche);
@@ -0,0 +1,59 @@
+/**
+ * Copyright (c) Alexander Kurtz 2026
+ */
+
+#pragma once
+
+/**
+ * EGDB container:
+ * All layers of one game mode in a single file, EGDB/egdb.edb or EGDB/egdb_av.edb.
+ *
+ * Layout (little endian):
+ *   header      magic, version, mode, value encoding, stone range, block size, alignment,
+ *               file size, hash of the layer index and hash of the header itself
+ *   index       per layer: payload offset, positions, offset and count of its block hashes
+ *   hashes      one 64-bit hash per block of each payload
+ *   payloads    raw layer values, each starting on an aligned offset
+ *
+ * The whole file is mapped at once, so the layers need no opens of their own. Header, index and
+ * layer bounds are checked when the file is opened, a file of the other mode or another encoding is
+ * rejected instead of being probed. Hashing every block would read the whole file on each open, so
+ * the block hashes are only checked on request.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define EGDB_CONTAINER_MAGIC 0x31424445 // "EDB1"
+#define EGDB_CONTAINER_VERSION 1
+#define EGDB_CONTAINER_ALIGNMENT 4096
+#define EGDB_CONTAINER_BLOCK_SIZE (1 << 20)
+
+#define EGDB_CONTAINER_AVALANCHE 0x1
+
+// int8 score difference for the side to move, normalized as in getEGDBIndex
+#define EGDB_ENCODING_SCORE_I8 1
+
+// Copies count values of layer s from index start, used to fill the payloads
+typedef bool (*EGDBLayerReader)(int s, uint64_t start, int8_t *buffer, uint64_t count);
+
+void egdbContainerPath(char *buffer, size_t size, bool is_avalanche);
+
+// Maps the container of the mode, returns its highest layer, 0 without a file, -1 if rejected
+int egdbContainerOpen(bool is_avalanche, char *reason, size_t reasonSize);
+
+// Clears the egdb_tables entries that point into the mapping before releasing it
+void egdbContainerClose();
+
+// Hashes every block of the open container, false with the first damaged block as reason
+bool egdbContainerVerify(uint64_t *blocks, char *reason, size_t reasonSize);
+
+// Values of layer s inside the mapping, NULL if the open container lacks it
+int8_t *egdbContainerLayer(int s, uint64_t *positions);
+
+// Whether a table points into the mapping, it is released with the container and not by a backend
+bool egdbContainerOwns(const int8_t *table);
+
+// Writes layers 1..max_stones with the given sizes, replaces an existing file only on success
+bool egdbContainerWrite(int max_stones, bool is_avalanche, const uint64_t *sizes, EGDBLayerReader reader);
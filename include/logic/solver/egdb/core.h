@@ -19,17 +19,97 @@
 
 #define EGDB_MAX_STONES 216
 #define EGDB_UNCOMPUTED 127
-#define EGDB_VISITING 126
+
+// Indices a generation thread claims at once, and the upper limit on threads
+#define EGDB_CHUNK_SIZE 4096
+#define EGDB_MAX_THREADS 256
 
 extern int8_t *egdb_tables[EGDB_MAX_STONES + 1];
 extern int loaded_egdb_max_stones;
 extern int egdb_total_stones_configured;
+extern int loaded_wdl_max_stones;
 
 void configureStoneCountEGDB(int stonesPerPit);
+
+// Threads used to generate a layer, 0 uses every core
+void setEGDBThreads(int threads);
+int getEGDBThreads();
+
+// Seconds between checkpoints of a layer in generation, 0 disables them
+#define EGDB_DEFAULT_CHECKPOINT_INTERVAL 600
+void setEGDBCheckpointInterval(int seconds);
+int getEGDBCheckpointInterval();
 void generateEGDB(int max_stones, bool is_avalanche);
 void loadEGDB(int max_stones);
 void freeEGDB();
 
+// Writes the loaded layers into the single file container of their mode, see container.h
+void packEGDB();
+
+// Checks the block hashes of the mapped container, a damaged one frees the EGDB
+void verifyEGDB();
+
+// Deletes layers 1..max_stones from disk, with the files derived from them and the container
+void removeEGDBFiles(int max_stones, bool is_avalanche);
+
+// Frees the layers above max_stones, the remaining ones stay usable
+void trimEGDB(int max_stones);
+
+// Memory of layers 1..max_stones, measured for loaded layers and estimated for the others
+uint64_t estimateEGDBSize(int max_stones);
+int planEGDBLayers(uint64_t budgetBytes);
+
 bool EGDB_probe(Board *board, int *score);
+
+/**
+ * Null window searches mostly need to know on which side of the window a value lies. Backends may
+ * keep the smallest and largest value of every block, if the whole block of a position is outside
+ * (alpha, beta) the probe returns that fail-soft bound without decoding or faulting in the block.
+ * Otherwise the result is the exact score of EGDB_probe.
+ */
+bool EGDB_probe_bound(Board *board, int alpha, int beta, int *score);
+uint64_t getEGDBBoundHits();
+
+// Smallest and largest value of every block of block_size values, two entries per block
+void summarizeEGDBBlocks(const int8_t *values, uint64_t size, uint64_t block_size, int8_t *bounds);
+
 void getEGDBStats(uint64_t *sizeBytes, uint64_t *hits, int *minStones, int *maxStones);
 void resetEGDBStats();
+
+// Block cache of compressed backends, all zero without one
+void getEGDBCacheStats(uint64_t *hits, uint64_t *misses, uint64_t *bytes);
+
+// Size of that cache, 0 disables it; false for backends without one or if it can't be allocated
+bool setEGDBCacheSize(uint64_t bytes);
+uint64_t getEGDBCacheSize();
+
+/**
+ * WDL bitbase:
+ * Only the sign of each layer value, 2 bits per position, so four times the positions of an int8
+ * layer fit in the same memory. Layers are derived once from the exact ones, loaded or on disk as
+ * EGDB/egdb_N.bin, and kept in EGDB/egdb_N.wdl. It is independent of the exact layers, so
+ * `egdb 16` together with `egdb wdl 20` probes exactly up to 16 stones and by sign up to 20.
+ *
+ * The sign belongs to the stones still in play. The search compares the total score, so a
+ * probe decides a node only if the bound it gives falls outside the window; the [0, 1] window
+ * of clip searches is where that happens most.
+ */
+#define EGDB_WDL_LOSS 0
+#define EGDB_WDL_DRAW 1
+#define EGDB_WDL_WIN 2
+#define EGDB_WDL_UNKNOWN 3
+
+// Layers 1..max_stones of the mode, 0 frees them
+void loadEGDBWDL(int max_stones, bool is_avalanche);
+void freeEGDBWDL();
+
+// Sign of the value of the stones left in play for the side to move: -1, 0 or 1
+bool EGDB_probe_wdl(Board *board, int *wdl);
+void getEGDBWDLStats(uint64_t *sizeBytes, uint64_t *hits, int *maxStones);
+
+// Frees the WDL layers above max_stones, and how many layers fit in budgetBytes
+void trimEGDBWDL(int max_stones);
+int planEGDBWDLLayers(uint64_t budgetBytes);
+
+// Times ranking and unranking of boards with the given stones and checks that they round trip
+void benchmarkEGDBIndex(int stones, uint64_t samples);
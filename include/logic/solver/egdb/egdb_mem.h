@@ -12,12 +12,35 @@ void egdb_mem_init(void);
 
 bool egdb_mem_load(int s, uint64_t size, bool is_avalanche);
 
-void egdb_mem_save(int s, uint64_t size, bool is_avalanche);
+// Writes a generated layer to disk and keeps it loaded, false if either fails
+bool egdb_mem_save(int s, uint64_t size, bool is_avalanche);
 
-void egdb_mem_alloc(int s, uint64_t size);
+// Persists a layer in generation to EGDB/egdb_N.bin.tmp, which resume maps or reads back
+bool egdb_mem_checkpoint(int s, uint64_t size, bool is_avalanche);
+bool egdb_mem_resume(int s, uint64_t size, bool is_avalanche);
+
+// Backends that map files may place the layer on disk, so it can grow beyond RAM
+void egdb_mem_alloc(int s, uint64_t size, bool is_avalanche);
 
 void egdb_mem_free_layer(int s, uint64_t size);
 
+// Deletes the files the backend derived from EGDB/egdb_N.bin
+void egdb_mem_remove(int s, bool is_avalanche);
+
 bool egdb_mem_probe(int s, uint64_t idx, int8_t *val);
 
+// Smallest and largest value of the block holding idx from its summary, false without summaries
+bool egdb_mem_probe_bound(int s, uint64_t idx, int8_t *lower, int8_t *upper);
+
+// Ascending indices, compressed layers decode each block once for all its indices
+bool egdb_mem_probe_batch(int s, const uint64_t *idx, int8_t *vals, int count);
+
 uint64_t egdb_mem_get_size(int s, uint64_t size_uncompressed);
+
+// Cache of decompressed blocks, zero for backends without one
+void egdb_mem_get_cache_stats(uint64_t *hits, uint64_t *misses, uint64_t *bytes);
+void egdb_mem_reset_cache_stats(void);
+
+// Configured size of that cache, false and 0 for backends without one
+bool egdb_mem_set_cache_size(uint64_t bytes);
+uint64_t egdb_mem_get_cache_size(void);
@@ -10,6 +10,13 @@
 #define TAG_TYPE uint16_t
 #endif
 
+#if CACHE_DEPTH
+#define SLOT_UNSET CACHE_VAL_UNSET
+#else
+// No-depth slots keep a lower and an upper bound, so MTD(f) probes refine instead of replace
+#define SLOT_UNSET CACHE_BOUNDS_UNSET
+#endif
+
 // --- Struct Definition ---
 typedef struct {
     TAG_TYPE tag_0;
@@ -44,10 +51,17 @@ static void FN(freeCacheInternal)() {
     }
 }
 
-static void FN(initCacheInternal)(uint64_t size) {
+// Hands ownership of the table to the caller, used to rehash into a new configuration.
+static void *FN(detachCacheInternal)() {
+    void *table = FN(cache);
+    FN(cache) = NULL;
+    return table;
+}
+
+static bool FN(initCacheInternal)(uint64_t size) {
     FN(freeCacheInternal)
     ();
-    if (size == 0) return;
+    if (size == 0) return true;
 
     // Allocate half the number of structs, as each Bucket holds 2 entries
     uint64_t bucketCount = size >> 1;
@@ -55,15 +69,15 @@ static void FN(initCacheInternal)(uint64_t size) {
 
     FN(cache) = malloc(sizeof(FN(Bucket)) * bucketCount);
 
-    if (FN(cache) == NULL) return;
+    if (FN(cache) == NULL) return false;
 
     for (uint64_t i = 0; i < bucketCount; i++) {
         FN(cache)
-        [i].value_0 = CACHE_VAL_UNSET;
+        [i].value_0 = SLOT_UNSET;
         FN(cache)
         [i].tag_0 = 0;
         FN(cache)
-        [i].value_1 = CACHE_VAL_UNSET;
+        [i].value_1 = SLOT_UNSET;
         FN(cache)
         [i].tag_1 = 0;
 
@@ -74,6 +88,8 @@ static void FN(initCacheInternal)(uint64_t size) {
         [i].depth_1 = 0;
 #endif
     }
+
+    return true;
 }
 
 // --- Logic ---
@@ -196,16 +212,82 @@ static inline uint64_t FN(mergeBoard)(uint64_t bucketIndex, TAG_TYPE tag) {
     return ((uint64_t)tag << (cacheSizePow - 1)) | bucketIndex;
 }
 
-static inline void FN(cacheNodeHash)(Board *board, uint64_t boardRep, int evaluation, int boundType, int depth, bool solved) {
+#if !CACHE_DEPTH
+// Representable bound closest to the given one that is still valid, out of range values weaken to infinity
+static inline int FN(clampLower)(int evaluation) {
+    if (evaluation > CACHE_BOUND_MAX) return CACHE_BOUND_MAX;
+    if (evaluation < CACHE_BOUND_MIN) return CACHE_BOUND_NEG_INF;
+    return evaluation;
+}
+
+static inline int FN(clampUpper)(int evaluation) {
+    if (evaluation < CACHE_BOUND_MIN) return CACHE_BOUND_MIN;
+    if (evaluation > CACHE_BOUND_MAX) return CACHE_BOUND_POS_INF;
+    return evaluation;
+}
+
+static inline int16_t FN(mergeBounds)(int16_t old, int evaluation, int boundType) {
+    int lower = CACHE_BOUND_NEG_INF;
+    int upper = CACHE_BOUND_POS_INF;
+    const int newLower = (boundType != UPPER_BOUND) ? FN(clampLower)(evaluation) : CACHE_BOUND_NEG_INF;
+    const int newUpper = (boundType != LOWER_BOUND) ? FN(clampUpper)(evaluation) : CACHE_BOUND_POS_INF;
+
+    if (old != SLOT_UNSET) {
+        lower = UNPACK_LOWER(old);
+        upper = UNPACK_UPPER(old);
+    }
+
+    lower = max(lower, newLower);
+    upper = min(upper, newUpper);
+
+    // Contradicting bounds, trust the latest search
+    if (lower > upper) {
+        lower = newLower;
+        upper = newUpper;
+    }
+
+    return PACK_BOUNDS(lower, upper);
+}
+#endif
+
+#if CACHE_DEPTH
+// Replacement score of a subtree, log4 of its node count so it fits the 4 spare bits of the depth field
+static inline int FN(workScore)(uint64_t work) {
+    if (work <= 1) return 0;
+    int score = (63 - __builtin_clzll(work)) >> 1;
+    return (score > ENTRY_WORK_MAX) ? ENTRY_WORK_MAX : score;
+}
+#endif
+
+static inline bool FN(isExact)(int16_t value) {
+#if CACHE_DEPTH
+    return UNPACK_BOUND(value) == EXACT_BOUND;
+#else
+    return UNPACK_LOWER(value) == UNPACK_UPPER(value);
+#endif
+}
+
+static inline void FN(cacheNodeHash)(Board *board, uint64_t boardRep, int evaluation, int boundType, int depth, bool solved, uint64_t work) {
     int scoreDelta = board->cells[SCORE_P1] - board->cells[SCORE_P2];
     scoreDelta *= board->color;
     evaluation -= scoreDelta;
 
+#if CACHE_DEPTH
     if (evaluation > CACHE_VAL_MAX || evaluation < CACHE_VAL_MIN) {
         failedEncodeValueRange++;
         return;
     }
 
+    const int16_t value = PACK_VALUE(evaluation, boundType);
+#else
+    // Still stored, but weakened to the nearest representable bound
+    if (evaluation > CACHE_BOUND_MAX || evaluation < CACHE_BOUND_MIN) {
+        failedEncodeValueRange++;
+    }
+
+    const int16_t value = FN(mergeBounds)(SLOT_UNSET, evaluation, boundType);
+#endif
+
     uint64_t index;
     TAG_TYPE tag;
     FN(splitBoard)
@@ -214,48 +296,52 @@ static inline void FN(cacheNodeHash)(Board *board, uint64_t boardRep, int evalua
     FN(Bucket) *b = &FN(cache)[index];
 
 #if CACHE_DEPTH
-    if (solved) {
-        depth = DEPTH_SOLVED;
-    }
+    const int storedDepth = solved ? ENTRY_DEPTH_SOLVED : min(depth, ENTRY_DEPTH_MAX);
+    const uint16_t depthField = PACK_DEPTH(storedDepth, FN(workScore)(work));
 #else
     (void)depth;
     (void)solved;
+    (void)work;
 #endif
 
     // --- Same-key update ---
     if (b->tag_0 == tag) {
 #if CACHE_DEPTH
-        if (b->depth_0 > depth) return;
-        b->depth_0 = depth;
+        if (UNPACK_DEPTH(b->depth_0) > storedDepth) return;
+        b->depth_0 = depthField;
+        b->value_0 = value;
+#else
+        b->value_0 = FN(mergeBounds)(b->value_0, evaluation, boundType);
 #endif
-        b->value_0 = PACK_VALUE(evaluation, boundType);
         sameKeyOverwriteCount++;
         return;
     }
     if (b->tag_1 == tag) {
 #if CACHE_DEPTH
-        if (b->depth_1 > depth) return;
-        b->depth_1 = depth;
+        if (UNPACK_DEPTH(b->depth_1) > storedDepth) return;
+        b->depth_1 = depthField;
+        b->value_1 = value;
+#else
+        b->value_1 = FN(mergeBounds)(b->value_1, evaluation, boundType);
 #endif
-        b->value_1 = PACK_VALUE(evaluation, boundType);
         sameKeyOverwriteCount++;
         return;
     }
 
     // --- Empty slot ---
-    if (b->value_0 == CACHE_VAL_UNSET) {
-        b->value_0 = PACK_VALUE(evaluation, boundType);
+    if (b->value_0 == SLOT_UNSET) {
+        b->value_0 = value;
         b->tag_0 = tag;
 #if CACHE_DEPTH
-        b->depth_0 = depth;
+        b->depth_0 = depthField;
 #endif
         return;
     }
-    if (b->value_1 == CACHE_VAL_UNSET) {
-        b->value_1 = PACK_VALUE(evaluation, boundType);
+    if (b->value_1 == SLOT_UNSET) {
+        b->value_1 = value;
         b->tag_1 = tag;
 #if CACHE_DEPTH
-        b->depth_1 = depth;
+        b->depth_1 = depthField;
 #endif
         return;
     }
@@ -265,35 +351,42 @@ static inline void FN(cacheNodeHash)(Board *board, uint64_t boardRep, int evalua
     victimOverwriteCount++;
 
 #if CACHE_DEPTH
-    if (b->depth_1 != b->depth_0) {
-        victim = (b->depth_1 < b->depth_0) ? 1 : 0;
+    const int depth0 = UNPACK_DEPTH(b->depth_0);
+    const int depth1 = UNPACK_DEPTH(b->depth_1);
+    const int work0 = UNPACK_WORK(b->depth_0);
+    const int work1 = UNPACK_WORK(b->depth_1);
+
+    if (replaceByWork && work1 != work0) {
+        victim = (work1 < work0) ? 1 : 0;
+    } else if (depth1 != depth0) {
+        victim = (depth1 < depth0) ? 1 : 0;
     } else {
-        const int zeroExact = (UNPACK_BOUND(b->value_0) == EXACT_BOUND);
-        const int oneExact = (UNPACK_BOUND(b->value_1) == EXACT_BOUND);
+        const int zeroExact = FN(isExact)(b->value_0);
+        const int oneExact = FN(isExact)(b->value_1);
         victim = (zeroExact != oneExact) ? (zeroExact ? 1 : 0) : 1;
     }
 #else
-    const int zeroExact = (UNPACK_BOUND(b->value_0) == EXACT_BOUND);
-    const int oneExact = (UNPACK_BOUND(b->value_1) == EXACT_BOUND);
+    const int zeroExact = FN(isExact)(b->value_0);
+    const int oneExact = FN(isExact)(b->value_1);
     victim = (zeroExact != oneExact) ? (zeroExact ? 1 : 0) : 1;
 #endif
 
     if (victim == 0) {
         b->tag_0 = tag;
-        b->value_0 = PACK_VALUE(evaluation, boundType);
+        b->value_0 = value;
 #if CACHE_DEPTH
-        b->depth_0 = depth;
+        b->depth_0 = depthField;
 #endif
     } else {
         b->tag_1 = tag;
-        b->value_1 = PACK_VALUE(evaluation, boundType);
+        b->value_1 = value;
 #if CACHE_DEPTH
-        b->depth_1 = depth;
+        b->depth_1 = depthField;
 #endif
     }
 }
 
-static inline bool FN(getCachedValueHash)(Board *board, uint64_t hashValue, int currentDepth, int *eval, int *boundType, bool *solved) {
+static inline bool FN(getCachedValueHash)(Board *board, uint64_t hashValue, int currentDepth, int *lower, int *upper, bool *solved) {
     uint64_t index;
     TAG_TYPE tag;
     FN(splitBoard)
@@ -308,7 +401,7 @@ static inline bool FN(getCachedValueHash)(Board *board, uint64_t hashValue, int
     else return false;
 
     int16_t valToCheck = (matchSlot == 0) ? b->value_0 : b->value_1;
-    if (valToCheck == CACHE_VAL_UNSET) return false;
+    if (valToCheck == SLOT_UNSET) return false;
 
     // LRU Swap
     if (matchSlot == 1) {
@@ -329,8 +422,8 @@ static inline bool FN(getCachedValueHash)(Board *board, uint64_t hashValue, int
     hits++;
 
 #if CACHE_DEPTH
-    if (b->depth_0 < currentDepth) return false;
-    *solved = (b->depth_0 == DEPTH_SOLVED);
+    if (UNPACK_DEPTH(b->depth_0) < min(currentDepth, ENTRY_DEPTH_MAX)) return false;
+    *solved = (UNPACK_DEPTH(b->depth_0) == ENTRY_DEPTH_SOLVED);
 #else
     (void)currentDepth;
     *solved = true;
@@ -341,12 +434,66 @@ static inline bool FN(getCachedValueHash)(Board *board, uint64_t hashValue, int
     int scoreDelta = board->cells[SCORE_P1] - board->cells[SCORE_P2];
     scoreDelta *= board->color;
 
-    *eval = UNPACK_VALUE(b->value_0) + scoreDelta;
-    *boundType = UNPACK_BOUND(b->value_0);
+#if CACHE_DEPTH
+    const int value = UNPACK_VALUE(b->value_0) + scoreDelta;
+    const int bt = UNPACK_BOUND(b->value_0);
+    *lower = (bt == UPPER_BOUND) ? CACHE_NO_LOWER : value;
+    *upper = (bt == LOWER_BOUND) ? CACHE_NO_UPPER : value;
+#else
+    const int lo = UNPACK_LOWER(b->value_0);
+    const int up = UNPACK_UPPER(b->value_0);
+    *lower = (lo == CACHE_BOUND_NEG_INF) ? CACHE_NO_LOWER : lo + scoreDelta;
+    *upper = (up == CACHE_BOUND_POS_INF) ? CACHE_NO_UPPER : up + scoreDelta;
+#endif
 
     return true;
 }
 
+// --- Rehash ---
+
+/**
+ * Walks a detached table of this layout and hands every live entry to migrateEntry.
+ * Keys are rebuilt with the old size since mergeBoard reads the active configuration.
+ */
+static void FN(migrateCacheInternal)(void *table, uint64_t size, uint32_t sizePow) {
+    FN(Bucket) *old = table;
+    uint64_t bucketCount = size >> 1;
+    if (bucketCount == 0) bucketCount = 1;
+
+    for (uint64_t i = 0; i < bucketCount; i++) {
+        FN(Bucket) *b = &old[i];
+
+        for (int slot = 0; slot < 2; slot++) {
+            int16_t val = (slot == 0) ? b->value_0 : b->value_1;
+            if (val == SLOT_UNSET) continue;
+
+            TAG_TYPE tag = (slot == 0) ? b->tag_0 : b->tag_1;
+            Board brd = FN(untranslateBoard)(((uint64_t)tag << (sizePow - 1)) | i);
+
+#if CACHE_DEPTH
+            uint16_t field = (slot == 0) ? b->depth_0 : b->depth_1;
+            uint16_t d = UNPACK_DEPTH(field);
+            uint64_t work = (uint64_t)1 << (2 * UNPACK_WORK(field));
+            if (d == ENTRY_DEPTH_SOLVED) {
+                migrateEntry(&brd, UNPACK_VALUE(val), UNPACK_BOUND(val), DEPTH_SOLVED, true, work);
+            } else {
+                migrateEntry(&brd, UNPACK_VALUE(val), UNPACK_BOUND(val), d, false, work);
+            }
+#else
+            // No-depth tables only ever hold fully searched subtrees, each finite bound moves on its own
+            const int lo = UNPACK_LOWER(val);
+            const int up = UNPACK_UPPER(val);
+            if (lo == up) {
+                migrateEntry(&brd, lo, EXACT_BOUND, DEPTH_SOLVED, true, 0);
+                continue;
+            }
+            if (lo != CACHE_BOUND_NEG_INF) migrateEntry(&brd, lo, LOWER_BOUND, DEPTH_SOLVED, true, 0);
+            if (up != CACHE_BOUND_POS_INF) migrateEntry(&brd, up, UPPER_BOUND, DEPTH_SOLVED, true, 0);
+#endif
+        }
+    }
+}
+
 // --- Stats Collector ---
 
 static void FN(collectCacheStats)(CacheStats *stats, bool calcFrag, bool calcStoneDist, bool calcDepthDist) {
@@ -357,6 +504,7 @@ static void FN(collectCacheStats)(CacheStats *stats, bool calcFrag, bool calcSto
     uint64_t exactCount = 0;
     uint64_t lowerCount = 0;
     uint64_t upperCount = 0;
+    uint64_t windowCount = 0;
 
 #if CACHE_DEPTH
     uint64_t solvedEntries = 0;
@@ -393,7 +541,7 @@ static void FN(collectCacheStats)(CacheStats *stats, bool calcFrag, bool calcSto
     uint64_t chunkStart = 0;
     uint64_t chunkSize = 0;
 
-    int currentType = (FN(cache)[0].value_0 != CACHE_VAL_UNSET);
+    int currentType = (FN(cache)[0].value_0 != SLOT_UNSET);
 
     uint64_t bucketCount = cacheSize >> 1;
 
@@ -402,7 +550,7 @@ static void FN(collectCacheStats)(CacheStats *stats, bool calcFrag, bool calcSto
 
         for (int slot = 0; slot < 2; slot++) {
             int16_t val = (slot == 0) ? b->value_0 : b->value_1;
-            int type = (val != CACHE_VAL_UNSET);
+            int type = (val != SLOT_UNSET);
 
             if (calcFrag) {
                 if (i == 0 && slot == 0) {
@@ -430,14 +578,23 @@ static void FN(collectCacheStats)(CacheStats *stats, bool calcFrag, bool calcSto
             if (!type) continue;
 
             setEntries++;
+#if CACHE_DEPTH
             int bt = UNPACK_BOUND(val);
             if (bt == EXACT_BOUND) exactCount++;
             else if (bt == LOWER_BOUND) lowerCount++;
             else upperCount++;
+#else
+            const int lo = UNPACK_LOWER(val);
+            const int up = UNPACK_UPPER(val);
+            if (lo == up) exactCount++;
+            else if (up == CACHE_BOUND_POS_INF) lowerCount++;
+            else if (lo == CACHE_BOUND_NEG_INF) upperCount++;
+            else windowCount++;
+#endif
 
 #if CACHE_DEPTH
-            uint16_t d = (slot == 0) ? b->depth_0 : b->depth_1;
-            if (d == DEPTH_SOLVED) {
+            uint16_t d = UNPACK_DEPTH((slot == 0) ? b->depth_0 : b->depth_1);
+            if (d == ENTRY_DEPTH_SOLVED) {
                 solvedEntries++;
             } else {
                 nonSolvedCount++;
@@ -468,6 +625,7 @@ static void FN(collectCacheStats)(CacheStats *stats, bool calcFrag, bool calcSto
     stats->exactCount = exactCount;
     stats->lowerCount = lowerCount;
     stats->upperCount = upperCount;
+    stats->windowCount = windowCount;
 
 #if CACHE_DEPTH
     stats->solvedEntries = solvedEntries;
@@ -504,10 +662,10 @@ static void FN(collectCacheStats)(CacheStats *stats, bool calcFrag, bool calcSto
 
             for (int slot = 0; slot < 2; slot++) {
                 int16_t val = (slot == 0) ? b->value_0 : b->value_1;
-                if (val == CACHE_VAL_UNSET) continue;
+                if (val == SLOT_UNSET) continue;
 
-                uint16_t d = (slot == 0) ? b->depth_0 : b->depth_1;
-                if (d == DEPTH_SOLVED) continue;
+                uint16_t d = UNPACK_DEPTH((slot == 0) ? b->depth_0 : b->depth_1);
+                if (d == ENTRY_DEPTH_SOLVED) continue;
 
                 uint32_t bi = d / binW;
                 if (bi >= DEPTH_BINS) bi = DEPTH_BINS - 1;
@@ -541,3 +699,4 @@ static void FN(collectCacheStats)(CacheStats *stats, bool calcFrag, bool calcSto
 }
 
 #undef TAG_TYPE
+#undef SLOT_UNSET
@@ -12,3 +12,13 @@
 #define PACK_VALUE(eval, bt) ((int16_t)(((eval) << 2) | ((bt) & 0x3)))
 #define UNPACK_VALUE(val) ((int16_t)((val) >> 2))
 #define UNPACK_BOUND(val) ((val) & 0x3)
+
+// Two-bound slot: int8 lower bound in the low byte, int8 upper bound in the high byte
+#define PACK_BOUNDS(lower, upper) ((int16_t)(((uint16_t)(uint8_t)(int8_t)(upper) << 8) | (uint8_t)(int8_t)(lower)))
+#define UNPACK_LOWER(val) ((int8_t)((uint16_t)(val) & 0xFF))
+#define UNPACK_UPPER(val) ((int8_t)((uint16_t)(val) >> 8))
+
+// Depth slot: searched depth in the low 12 bits, subtree work score in the high 4 bits
+#define PACK_DEPTH(depth, work) ((uint16_t)(((work) << 12) | (depth)))
+#define UNPACK_DEPTH(field) ((field) & 0x0FFF)
+#define UNPACK_WORK(field) ((field) >> 12)
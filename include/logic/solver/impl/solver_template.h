@@ -33,34 +33,49 @@ static int FN(negamax)(Board *board, int alpha, int beta, const int depth) {
     nodeCount++;
 
 #if USE_EGDB
+    // Exact, or a bound from the block summary if that already falls outside the window
     int egdb_score;
-    if (EGDB_probe(board, &egdb_score)) {
+    if (EGDB_probe_bound(board, alpha, beta, &egdb_score)) {
 #if SOLVER_USE_CACHE
         *solved = true;
 #endif
         return egdb_score;
     }
+
+    // The sign of the stones left bounds the total score from one side, enough if that side is out of the window
+    int wdl;
+    if (loaded_wdl_max_stones > 0 && EGDB_probe_wdl(board, &wdl)) {
+        const int currentDiff = board->color * (board->cells[SCORE_P1] - board->cells[SCORE_P2]);
+        if (wdl == 0 || (wdl > 0 && currentDiff + 1 >= beta) || (wdl < 0 && currentDiff - 1 <= alpha)) {
+#if SOLVER_USE_CACHE
+            *solved = true;
+#endif
+            return currentDiff + wdl;
+        }
+    }
 #endif
 
 #if SOLVER_USE_CACHE
     uint64_t boardHash = 0;
     bool hashValid = translateBoard(board, &boardHash);
+    const int64_t nodesBefore = nodeCount;
 
-    int cachedValue;
-    int boundType;
+    int cachedLower;
+    int cachedUpper;
     bool cachedSolved;
-    if (hashValid && getCachedValueHash(board, boardHash, depth, &cachedValue, &boundType, &cachedSolved)) {
-        if (boundType == EXACT_BOUND) {
+    if (hashValid && getCachedValueHash(board, boardHash, depth, &cachedLower, &cachedUpper, &cachedSolved)) {
+        if (cachedLower == cachedUpper || cachedLower >= beta) {
             *solved = cachedSolved;
-            return cachedValue;
+            return cachedLower;
         }
-        if (boundType == LOWER_BOUND) alpha = max(alpha, cachedValue);
-        else if (boundType == UPPER_BOUND) beta = min(beta, cachedValue);
-
-        if (alpha >= beta) {
+        if (cachedUpper <= alpha) {
             *solved = cachedSolved;
-            return cachedValue;
+            return cachedUpper;
         }
+
+        // Both sides at once, a window from earlier MTD(f) probes narrows the search from above and below
+        alpha = max(alpha, cachedLower);
+        beta = min(beta, cachedUpper);
     }
 #endif
 
@@ -135,11 +150,12 @@ static int FN(negamax)(Board *board, int alpha, int beta, const int depth) {
 
 #if SOLVER_USE_CACHE
     if (hashValid) {
+        int boundType;
         if (reference <= alphaOriginal) boundType = UPPER_BOUND;
         else if (reference >= beta) boundType = LOWER_BOUND;
         else boundType = EXACT_BOUND;
 
-        cacheNodeHash(board, boardHash, reference, boundType, depth, nodeSolved);
+        cacheNodeHash(board, boardHash, reference, boundType, depth, nodeSolved, (uint64_t)(nodeCount - nodesBefore));
     }
     *solved = nodeSolved;
 #endif
@@ -264,9 +280,9 @@ void FN(distributionRoot)(Board *board, int *distribution, bool *solvedOutput, S
     int depth = config->depth;
     if (config->depth == 0) {
         depth = MAX_DEPTH;
-        setCacheMode(false, config->compressCache);
+        setCacheMode(false, config);
     } else {
-        setCacheMode(true, config->compressCache);
+        setCacheMode(true, config);
     }
 #else
     int depth = (config->depth == 0) ? MAX_DEPTH : config->depth;
@@ -329,7 +345,7 @@ void FN(binarySearchRoot)(Context *context, SolverConfig *config) {
     int currentDepth = MAX_DEPTH;
 
 #if SOLVER_USE_CACHE
-    setCacheMode(false, config->compressCache);
+    setCacheMode(false, config);
     bool solved = false;
 #endif
 
@@ -459,7 +475,7 @@ void FN(aspirationRoot)(Context *context, SolverConfig *config) {
     int bestMove = -1;
     int score = 0;
 #if SOLVER_USE_CACHE
-    setCacheMode(true, config->compressCache);
+    setCacheMode(true, config);
     bool solved = false;
 #endif
     const int windowSize = 1;
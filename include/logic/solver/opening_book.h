@@ -6,3 +6,6 @@
 #include "logic/solver/opening_book_data.h"
 
 bool probeOpeningBook(const Board *board, int *bestMove, int *eval);
+
+// Bytes of the compiled in book tables
+uint64_t getOpeningBookSize();
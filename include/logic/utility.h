@@ -10,6 +10,7 @@
 #include <ctype.h>
 #include <stdint.h>
 #include <math.h>
+#include <time.h>
 
 #ifndef _WIN32
 #include <unistd.h>
@@ -47,3 +48,18 @@ void quitGame();
 void updateCell(Board *board, int player, int idx, int value);
 void getLogNotation(char *buffer, uint64_t value);
 void storeBenchmarkData(const char *fileName, double *data);
+
+// Installed RAM in bytes, 0 if unknown
+uint64_t getPhysicalMemory();
+
+int getProcessorCount();
+
+// Seconds of real time, unlike clock() it does not add up the time of all threads
+double getWallTime();
+
+/**
+ * Streams a file through write(f, context) into path.part, syncs it and renames it over path, so a
+ * crash leaves either the old file or the whole new one. Processes that still map the old file
+ * keep reading it, the rename only swaps the directory entry.
+ */
+bool writeFileReplacing(const char *path, bool (*write)(FILE *f, void *context), void *context);
@@ -11,5 +11,10 @@
 #include "logic/solver/egdb/core.h"
 
 #define BENCHMARK_CACHE_POW 24
+#define INDEX_BENCHMARK_STONES 24
+#define INDEX_BENCHMARK_SAMPLES 20000000
 
 void runBenchmark();
+
+// Microbenchmark of EGDB ranking and unranking, --benchmark index [stones]
+void runIndexBenchmark(int stones);
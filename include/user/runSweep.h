@@ -0,0 +1,28 @@
+/**
+ * Copyright (c) Alexander Kurtz 2026
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "logic/solver/algo.h"
+#include "logic/solver/cache.h"
+
+#define SWEEP_DEFAULT_STONES 3
+#define SWEEP_DEFAULT_MIN_POW 18
+#define SWEEP_DEFAULT_MAX_POW 24
+#define SWEEP_MAX_POW 28
+#define SWEEP_DEFAULT_FILE "sweep.csv"
+
+/**
+ * Cache sweep:
+ * Solves the start position once with a cache of the largest size and replays every probe and
+ * store on simulated tables of all sizes in the range, direct mapped, 2-way and 4-way, each with
+ * LRU replacement. The simulated tables only hold tags, so one run gives the hit rate curve that
+ * otherwise takes a full solve per size. The search tree is the one of the largest size; smaller
+ * tables would also grow the tree, so the curve is a lower bound on the real cost of shrinking.
+ *
+ * Usage: --sweep [stones] [minPow] [maxPow] [file]
+ */
+void runSweep(int argc, char const *argv[]);
@@ -129,7 +129,7 @@ void binarySearchRoot(Context *context, SolverConfig *config) {
     else binarySearchRoot_TT_EGDB_AVALANCHE(context, config);
 #else
     bool use_tt = (config->solver == LOCAL_SOLVER);
-    bool use_egdb = (loaded_egdb_max_stones > 0);
+    bool use_egdb = (loaded_egdb_max_stones > 0 || loaded_wdl_max_stones > 0);
 
     if (use_tt && use_egdb && is_classic) binarySearchRoot_TT_EGDB_CLASSIC(context, config);
     else if (use_tt && !use_egdb && is_classic) binarySearchRoot_TT_CLASSIC(context, config);
@@ -182,7 +182,7 @@ void aspirationRoot(Context *context, SolverConfig *config) {
     else aspirationRoot_TT_EGDB_AVALANCHE(context, config);
 #else
     bool use_tt = (config->solver == LOCAL_SOLVER);
-    bool use_egdb = (loaded_egdb_max_stones > 0);
+    bool use_egdb = (loaded_egdb_max_stones > 0 || loaded_wdl_max_stones > 0);
 
     if (use_tt && use_egdb && is_classic) aspirationRoot_TT_EGDB_CLASSIC(context, config);
     else if (use_tt && !use_egdb && is_classic) aspirationRoot_TT_CLASSIC(context, config);
@@ -206,7 +206,7 @@ void distributionRoot(Board *board, int32_t *distribution, bool *solved, SolverC
     else distributionRoot_TT_EGDB_AVALANCHE(board, distribution, solved, config);
 #else
     bool use_tt = (config->solver == LOCAL_SOLVER);
-    bool use_egdb = (loaded_egdb_max_stones > 0);
+    bool use_egdb = (loaded_egdb_max_stones > 0 || loaded_wdl_max_stones > 0);
 
     if (use_tt && use_egdb && is_classic) distributionRoot_TT_EGDB_CLASSIC(board, distribution, solved, config);
     else if (use_tt && !use_egdb && is_classic) distributionRoot_TT_CLASSIC(board, distribution, solved, config);
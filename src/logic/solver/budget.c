@@ -0,0 +1,140 @@
+/**
+ * Copyright (c) Alexander Kurtz 2026
+ */
+
+#include "logic/solver/budget.h"
+#include "logic/solver/cache.h"
+#include "logic/solver/opening_book.h"
+#include "logic/solver/egdb/core.h"
+#include "logic/utility.h"
+
+static uint64_t memoryBudget = 0;
+
+void setMemoryBudget(uint64_t bytes) {
+    memoryBudget = bytes;
+}
+
+uint64_t getMemoryBudget() {
+    return memoryBudget;
+}
+
+static void formatBytes(char *buffer, size_t size, uint64_t bytes) {
+    if (bytes >= ((uint64_t)1 << 30)) {
+        snprintf(buffer, size, "%.2f GB", (double)bytes / 1073741824.0);
+    } else if (bytes >= ((uint64_t)1 << 20)) {
+        snprintf(buffer, size, "%.2f MB", (double)bytes / 1048576.0);
+    } else {
+        snprintf(buffer, size, "%.2f KB", (double)bytes / 1024.0);
+    }
+}
+
+void applyMemoryBudget(SolverConfig *config, bool report) {
+    if (memoryBudget == 0) return;
+
+    char message[256];
+    char sizeStr[32];
+    char ramStr[32];
+
+    uint64_t budget = memoryBudget;
+    uint64_t physical = getPhysicalMemory();
+    uint64_t usable = (uint64_t)((double)physical * MEMORY_BUDGET_RAM_SHARE);
+    bool clamped = physical > 0 && budget > usable;
+    if (clamped) budget = usable;
+
+    if (report) {
+        formatBytes(sizeStr, sizeof(sizeStr), budget);
+        formatBytes(ramStr, sizeof(ramStr), physical);
+        snprintf(message, sizeof(message), "Memory budget: %s%s (RAM %s)", sizeStr, clamped ? " (clamped)" : "", ramStr);
+        renderOutput(message, CONFIG_PREFIX);
+    }
+
+    // --- Opening Book ---
+    uint64_t bookBytes = config->useOpeningBook ? getOpeningBookSize() : 0;
+    uint64_t remaining = budget > bookBytes ? budget - bookBytes : 0;
+
+    if (report && bookBytes > 0) {
+        formatBytes(sizeStr, sizeof(sizeStr), bookBytes);
+        snprintf(message, sizeof(message), "  Book:  %s", sizeStr);
+        renderOutput(message, CONFIG_PREFIX);
+    }
+
+    // --- EGDB ---
+    // Freeing layers is never silent, even on the quiet re-plan of `start`
+    uint64_t tableBudget = remaining / 2;
+    int layers = planEGDBLayers(tableBudget);
+    if (loaded_egdb_max_stones > layers) {
+        int loaded = loaded_egdb_max_stones;
+        trimEGDB(layers);
+        snprintf(message, sizeof(message), "Memory budget: freed EGDB layers %d..%d", layers + 1, loaded);
+        renderOutput(message, CONFIG_PREFIX);
+    }
+
+    uint64_t egdbBytes = estimateEGDBSize(loaded_egdb_max_stones);
+    remaining -= egdbBytes;
+
+    if (report) {
+        if (loaded_egdb_max_stones > 0) {
+            formatBytes(sizeStr, sizeof(sizeStr), egdbBytes);
+            snprintf(message, sizeof(message), "  EGDB:  1..%d stones, %s", loaded_egdb_max_stones, sizeStr);
+        } else if (layers > 0) {
+            snprintf(message, sizeof(message), "  EGDB:  not loaded, up to %d stones fit (egdb %d)", layers, layers);
+        } else {
+            snprintf(message, sizeof(message), "  EGDB:  not loaded");
+        }
+        renderOutput(message, CONFIG_PREFIX);
+    }
+
+    // --- WDL, sharing the half of the exact layers ---
+    uint64_t wdlBytes, wdlHits;
+    int wdlStones;
+    getEGDBWDLStats(&wdlBytes, &wdlHits, &wdlStones);
+    int wdlLayers = planEGDBWDLLayers(tableBudget > egdbBytes ? tableBudget - egdbBytes : 0);
+    if (wdlStones > wdlLayers) {
+        trimEGDBWDL(wdlLayers);
+        snprintf(message, sizeof(message), "Memory budget: freed WDL layers %d..%d", wdlLayers + 1, wdlStones);
+        renderOutput(message, CONFIG_PREFIX);
+        getEGDBWDLStats(&wdlBytes, &wdlHits, &wdlStones);
+    }
+    remaining = remaining > wdlBytes ? remaining - wdlBytes : 0;
+
+    if (report && wdlStones > 0) {
+        formatBytes(sizeStr, sizeof(sizeStr), wdlBytes);
+        snprintf(message, sizeof(message), "  WDL:   1..%d stones, %s", wdlStones, sizeStr);
+        renderOutput(message, CONFIG_PREFIX);
+    }
+
+    // --- EGDB block cache, allocated with the first layer of a compressing backend ---
+    uint64_t blockHits, blockMisses, blockBytes;
+    getEGDBCacheStats(&blockHits, &blockMisses, &blockBytes);
+    remaining = remaining > blockBytes ? remaining - blockBytes : 0;
+
+    if (report && blockBytes > 0) {
+        formatBytes(sizeStr, sizeof(sizeStr), blockBytes);
+        snprintf(message, sizeof(message), "  Block: %s", sizeStr);
+        renderOutput(message, CONFIG_PREFIX);
+    }
+
+    // --- Cache ---
+    CacheMode compressMode = config->compressCache;
+    uint64_t cacheBytes = 0;
+    int sizePow = planCacheSize(remaining, config, &compressMode, &cacheBytes);
+
+    if (sizePow == 0) {
+        if (report) {
+            snprintf(message, sizeof(message), "  Cache: budget too small for 2^%d, keeping the current size", MIN_CACHE_SIZE);
+            renderOutput(message, CONFIG_PREFIX);
+        }
+        return;
+    }
+
+    setCacheSize(sizePow);
+    config->compressCache = compressMode;
+
+    if (report) {
+        const char *modeStr = (compressMode == ALWAYS_COMPRESS) ? "always" : (compressMode == NEVER_COMPRESS) ? "never"
+                                                                                                              : "auto";
+        formatBytes(sizeStr, sizeof(sizeStr), cacheBytes);
+        snprintf(message, sizeof(message), "  Cache: 2^%d, compress %s, %s", sizePow, modeStr, sizeStr);
+        renderOutput(message, CONFIG_PREFIX);
+    }
+}
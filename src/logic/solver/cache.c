@@ -31,6 +31,16 @@ uint64_t lastSwapLRUCount = 0;
 uint64_t lastFailedEncodeStoneCount = 0;
 uint64_t lastFailedEncodeValueRange = 0;
 
+// Replacement policy of the depth layouts
+static bool replaceByWork = false;
+
+// Observer of the probe and store stream, used by the cache sweep
+static CacheTraceHook traceHook = NULL;
+
+// Rehash stats (last reconfiguration)
+uint64_t rehashedEntries = 0;
+uint64_t rehashDroppedEntries = 0;
+
 // --- Helper ---
 typedef struct {
     uint64_t start;
@@ -54,6 +64,9 @@ int compareChunksStart(const void *a, const void *b) {
     return 0;
 }
 
+// Receives entries of a detached table during a rehash, defined after the dispatcher
+static void migrateEntry(Board *board, int evaluation, int boundType, int depth, bool solved, uint64_t work);
+
 // --- Template Instantiations ---
 
 // 1. NO DEPTH | 48 BIT KEY | 16 BIT TAG
@@ -132,6 +145,7 @@ typedef enum {
     MODE_D_B48_T16,
     MODE_D_B48_T32,
     MODE_D_B60_T32,
+    MODE_CLIP_B48_T20,
     MODE_COUNT
 } CacheDispatchMode;
 
@@ -140,10 +154,442 @@ static CacheDispatchMode currentMode = MODE_DISABLED;
 static bool configDepth = true;
 static CacheMode configCompressMode = AUTO;
 static int configSizePow = 0;
+static bool configClip = false;
+
+// The clip layout trades speed for density, so it is only used on request
+static bool clipLayout = false;
+
+static inline bool isDepthMode(CacheDispatchMode mode) {
+    return mode >= MODE_D_B48_T16 && mode <= MODE_D_B60_T32;
+}
+
+// --- Solved Table ---
+
+/**
+ * Solved results found while the main table is in depth mode are kept here, where depth limited
+ * entries can never evict them. Keys are the score independent 60-bit board codes split into
+ * bucket index and tag like the main table, each slot holds the tag above the packed value.
+ * Solved entries pushed out of a bucket spill into the main table instead of being lost.
+ */
+#define SOLVED_TABLE_MAGIC 0x4C4F5353 // "SSOL"
+#define SOLVED_TABLE_VERSION 1
+#define SOLVED_SLOT_UNSET UINT64_MAX
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t sizePow;
+    uint32_t moveFunction;
+} SolvedTableHeader;
+
+static uint64_t *solvedTable = NULL;
+static uint32_t solvedSizePow = 0;
+
+uint64_t solvedHits = 0;
+uint64_t solvedSpills = 0;
+uint64_t lastSolvedHits = 0;
+uint64_t lastSolvedSpills = 0;
+
+static void cacheNodeHashMain(Board *board, uint64_t boardRep, int evaluation, int boundType, int depth, bool solved, uint64_t work);
+
+static inline bool solvedTableActive() {
+    return solvedTable != NULL && isDepthMode(currentMode);
+}
+
+static inline uint64_t solvedBucketCount(uint32_t sizePow) {
+    return (uint64_t)1 << (sizePow - 1);
+}
+
+static void clearSolvedTable() {
+    if (solvedTable == NULL) return;
+    memset(solvedTable, 0xFF, sizeof(uint64_t) * 2 * solvedBucketCount(solvedSizePow));
+}
+
+static void spillSolvedEntry(uint64_t code, uint64_t slot) {
+    Board board = untranslateBoard_DEPTH_B60_T32(code);
+    int16_t value = (int16_t)(slot & 0xFFFF);
+
+    uint64_t boardRep;
+    if (!translateBoard(&board, &boardRep)) return;
+
+    cacheNodeHashMain(&board, boardRep, UNPACK_VALUE(value), UNPACK_BOUND(value), DEPTH_SOLVED, true, 0);
+    solvedSpills++;
+}
+
+static void storeSolvedCode(uint64_t code, int16_t value) {
+    uint64_t index = code & (solvedBucketCount(solvedSizePow) - 1);
+    uint64_t tag = code >> (solvedSizePow - 1);
+    uint64_t slot = (tag << 16) | (uint16_t)value;
+    uint64_t *b = &solvedTable[index << 1];
+
+    // --- Same-key update ---
+    if (b[0] != SOLVED_SLOT_UNSET && (b[0] >> 16) == tag) {
+        b[0] = slot;
+        return;
+    }
+    if (b[1] != SOLVED_SLOT_UNSET && (b[1] >> 16) == tag) {
+        b[1] = slot;
+        return;
+    }
+
+    // --- Empty slot ---
+    if (b[0] == SOLVED_SLOT_UNSET) {
+        b[0] = slot;
+        return;
+    }
+    if (b[1] == SOLVED_SLOT_UNSET) {
+        b[1] = slot;
+        return;
+    }
+
+    // --- Victim selection, the evicted result moves to the main table ---
+    const int zeroExact = (UNPACK_BOUND((int16_t)(b[0] & 0xFFFF)) == EXACT_BOUND);
+    const int oneExact = (UNPACK_BOUND((int16_t)(b[1] & 0xFFFF)) == EXACT_BOUND);
+    const int victim = (zeroExact != oneExact) ? (zeroExact ? 1 : 0) : 1;
+
+    uint64_t evicted = b[victim];
+    b[victim] = slot;
+    spillSolvedEntry(((evicted >> 16) << (solvedSizePow - 1)) | index, evicted);
+}
+
+static bool probeSolvedCode(uint64_t code, int16_t *value) {
+    uint64_t index = code & (solvedBucketCount(solvedSizePow) - 1);
+    uint64_t tag = code >> (solvedSizePow - 1);
+    uint64_t *b = &solvedTable[index << 1];
+
+    if (b[0] != SOLVED_SLOT_UNSET && (b[0] >> 16) == tag) {
+        *value = (int16_t)(b[0] & 0xFFFF);
+        return true;
+    }
+    if (b[1] != SOLVED_SLOT_UNSET && (b[1] >> 16) == tag) {
+        *value = (int16_t)(b[1] & 0xFFFF);
+
+        // LRU Swap
+        uint64_t t = b[0];
+        b[0] = b[1];
+        b[1] = t;
+        return true;
+    }
+    return false;
+}
+
+// Copies the live slots of a detached solved table into the current one
+static void migrateSolvedTable(uint64_t *table, uint32_t sizePow) {
+    uint64_t bucketCount = solvedBucketCount(sizePow);
+    for (uint64_t i = 0; i < bucketCount; i++) {
+        for (int s = 0; s < 2; s++) {
+            uint64_t slot = table[(i << 1) + s];
+            if (slot == SOLVED_SLOT_UNSET) continue;
+            storeSolvedCode(((slot >> 16) << (sizePow - 1)) | i, (int16_t)(slot & 0xFFFF));
+        }
+    }
+}
+
+// --- Leaf Table ---
+
+/**
+ * Nodes within a few plies of the horizon or with few stones left dominate the probes.
+ * They go to a small table that stays in the CPU caches instead of the main table, where they
+ * would cost a DRAM access each and evict the more valuable entries of the upper tree.
+ * Keys are the 48-bit board codes, a slot holds the tag above a depth field and the packed value.
+ */
+#define LEAF_SLOT_UNSET UINT64_MAX
+#define LEAF_TAG_SHIFT 28
+#define LEAF_DEPTH_SHIFT 16
+
+static uint64_t *leafTable = NULL;
+static uint32_t leafSizePow = 0;
+
+uint64_t leafHits = 0;
+uint64_t leafStores = 0;
+uint64_t lastLeafHits = 0;
+uint64_t lastLeafStores = 0;
+
+static inline uint64_t leafBucketCount(uint32_t sizePow) {
+    return (uint64_t)1 << (sizePow - 1);
+}
+
+static void clearLeafTable() {
+    if (leafTable == NULL) return;
+    memset(leafTable, 0xFF, sizeof(uint64_t) * 2 * leafBucketCount(leafSizePow));
+}
+
+static inline bool leafTableRoute(Board *board, int depth) {
+    if (leafTable == NULL) return false;
+
+    // Only depth layouts have a horizon, solves use the stone count alone
+    if (isDepthMode(currentMode) && depth <= LEAF_TABLE_DEPTH) return true;
+
+    int stones = 0;
+    for (int i = LBOUND_P1; i <= HBOUND_P1; i++)
+        stones += board->cells[i];
+    for (int i = LBOUND_P2; i <= HBOUND_P2; i++)
+        stones += board->cells[i];
+    return stones <= LEAF_TABLE_STONES;
+}
+
+static inline uint16_t leafSlotDepth(uint64_t slot) {
+    return (slot >> LEAF_DEPTH_SHIFT) & 0x0FFF;
+}
+
+static void storeLeafCode(uint64_t code, int16_t value, uint16_t depth) {
+    uint64_t index = code & (leafBucketCount(leafSizePow) - 1);
+    uint64_t tag = code >> (leafSizePow - 1);
+    uint64_t slot = (tag << LEAF_TAG_SHIFT) | ((uint64_t)depth << LEAF_DEPTH_SHIFT) | (uint16_t)value;
+    uint64_t *b = &leafTable[index << 1];
+
+    leafStores++;
+
+    // --- Same-key update ---
+    for (int i = 0; i < 2; i++) {
+        if (b[i] != LEAF_SLOT_UNSET && (b[i] >> LEAF_TAG_SHIFT) == tag) {
+            if (leafSlotDepth(b[i]) > depth) return;
+            b[i] = slot;
+            return;
+        }
+    }
+
+    // --- Empty slot ---
+    if (b[0] == LEAF_SLOT_UNSET) {
+        b[0] = slot;
+        return;
+    }
+    if (b[1] == LEAF_SLOT_UNSET) {
+        b[1] = slot;
+        return;
+    }
+
+    // --- Victim selection ---
+    int victim;
+    if (leafSlotDepth(b[0]) != leafSlotDepth(b[1])) {
+        victim = (leafSlotDepth(b[1]) < leafSlotDepth(b[0])) ? 1 : 0;
+    } else {
+        const int zeroExact = (UNPACK_BOUND((int16_t)(b[0] & 0xFFFF)) == EXACT_BOUND);
+        const int oneExact = (UNPACK_BOUND((int16_t)(b[1] & 0xFFFF)) == EXACT_BOUND);
+        victim = (zeroExact != oneExact) ? (zeroExact ? 1 : 0) : 1;
+    }
+    b[victim] = slot;
+}
+
+static bool probeLeafCode(uint64_t code, uint64_t *slot) {
+    uint64_t index = code & (leafBucketCount(leafSizePow) - 1);
+    uint64_t tag = code >> (leafSizePow - 1);
+    uint64_t *b = &leafTable[index << 1];
+
+    if (b[0] != LEAF_SLOT_UNSET && (b[0] >> LEAF_TAG_SHIFT) == tag) {
+        *slot = b[0];
+        return true;
+    }
+    if (b[1] != LEAF_SLOT_UNSET && (b[1] >> LEAF_TAG_SHIFT) == tag) {
+        *slot = b[1];
+
+        // LRU Swap
+        b[1] = b[0];
+        b[0] = *slot;
+        return true;
+    }
+    return false;
+}
+
+// --- Clip Layout ---
+
+/**
+ * Clip searches only ask whether a position is won, so bounds far from the current score
+ * difference are never needed. This layout keeps the 48-bit board key but stores both bounds with
+ * 6 bits each, relative to the score difference like the other layouts, so a slot fits 4 bytes
+ * once the tag is down to 20 bits. Bounds outside the small range are weakened, not dropped.
+ */
+#define CLIP_TAG_SHIFT 12
+#define CLIP_BOUND_BITS 6
+#define CLIP_BOUND_RANGE 31
+#define CLIP_SLOT_UNSET 0
+
+// Biased fields, 0 means no bound on that side so an all-zero slot is empty
+#define CLIP_SLOT_LOWER(slot) (((slot) >> CLIP_BOUND_BITS) & 0x3F)
+#define CLIP_SLOT_UPPER(slot) ((slot) & 0x3F)
+#define CLIP_LOWER_VALUE(field) ((int)(field) - (CLIP_BOUND_RANGE + 1))
+#define CLIP_UPPER_VALUE(field) ((CLIP_BOUND_RANGE + 1) - (int)(field))
+
+static uint32_t *clipCache = NULL;
+
+static void *detachClipCache() {
+    void *table = clipCache;
+    clipCache = NULL;
+    return table;
+}
+
+static bool initClipCache(uint64_t size) {
+    free(clipCache);
+    clipCache = NULL;
+    if (size == 0) return true;
+
+    // Two slots per bucket
+    clipCache = calloc(size, sizeof(uint32_t));
+    return clipCache != NULL;
+}
+
+static inline uint32_t clipLowerField(int evaluation) {
+    if (evaluation < -CLIP_BOUND_RANGE) return 0;
+    if (evaluation > CLIP_BOUND_RANGE) evaluation = CLIP_BOUND_RANGE;
+    return (uint32_t)(evaluation + CLIP_BOUND_RANGE + 1);
+}
+
+static inline uint32_t clipUpperField(int evaluation) {
+    if (evaluation > CLIP_BOUND_RANGE) return 0;
+    if (evaluation < -CLIP_BOUND_RANGE) evaluation = -CLIP_BOUND_RANGE;
+    return (uint32_t)(CLIP_BOUND_RANGE + 1 - evaluation);
+}
+
+static inline bool clipSlotExact(uint32_t slot) {
+    return CLIP_SLOT_LOWER(slot) != 0 && CLIP_SLOT_UPPER(slot) != 0 &&
+           CLIP_LOWER_VALUE(CLIP_SLOT_LOWER(slot)) == CLIP_UPPER_VALUE(CLIP_SLOT_UPPER(slot));
+}
+
+static void cacheNodeHashClip(Board *board, uint64_t boardRep, int evaluation, int boundType) {
+    int scoreDelta = (board->cells[SCORE_P1] - board->cells[SCORE_P2]) * board->color;
+    evaluation -= scoreDelta;
+
+    if (evaluation > CLIP_BOUND_RANGE || evaluation < -CLIP_BOUND_RANGE) {
+        failedEncodeValueRange++;
+    }
+
+    uint32_t lower = (boundType != UPPER_BOUND) ? clipLowerField(evaluation) : 0;
+    uint32_t upper = (boundType != LOWER_BOUND) ? clipUpperField(evaluation) : 0;
+
+    // Nothing left after weakening
+    if (lower == 0 && upper == 0) return;
+
+    uint64_t index = boardRep & ((cacheSize >> 1) - 1);
+    uint32_t tag = (uint32_t)(boardRep >> (cacheSizePow - 1));
+    uint32_t *b = &clipCache[index << 1];
+
+    // --- Same-key update ---
+    for (int i = 0; i < 2; i++) {
+        if (b[i] == CLIP_SLOT_UNSET || (b[i] >> CLIP_TAG_SHIFT) != tag) continue;
+
+        // Larger fields are tighter bounds on both sides
+        uint32_t mergedLower = max(lower, CLIP_SLOT_LOWER(b[i]));
+        uint32_t mergedUpper = max(upper, CLIP_SLOT_UPPER(b[i]));
+
+        // Contradicting bounds, trust the latest search
+        if (mergedLower != 0 && mergedUpper != 0 && CLIP_LOWER_VALUE(mergedLower) > CLIP_UPPER_VALUE(mergedUpper)) {
+            mergedLower = lower;
+            mergedUpper = upper;
+        }
+
+        b[i] = (tag << CLIP_TAG_SHIFT) | (mergedLower << CLIP_BOUND_BITS) | mergedUpper;
+        sameKeyOverwriteCount++;
+        return;
+    }
+
+    uint32_t slot = (tag << CLIP_TAG_SHIFT) | (lower << CLIP_BOUND_BITS) | upper;
+
+    // --- Empty slot ---
+    if (b[0] == CLIP_SLOT_UNSET) {
+        b[0] = slot;
+        return;
+    }
+    if (b[1] == CLIP_SLOT_UNSET) {
+        b[1] = slot;
+        return;
+    }
+
+    // --- Victim selection ---
+    victimOverwriteCount++;
+    const bool zeroExact = clipSlotExact(b[0]);
+    const bool oneExact = clipSlotExact(b[1]);
+    const int victim = (zeroExact != oneExact) ? (zeroExact ? 1 : 0) : 1;
+    b[victim] = slot;
+}
+
+static bool getCachedValueHashClip(Board *board, uint64_t hashValue, int *lower, int *upper, bool *solved) {
+    uint64_t index = hashValue & ((cacheSize >> 1) - 1);
+    uint32_t tag = (uint32_t)(hashValue >> (cacheSizePow - 1));
+    uint32_t *b = &clipCache[index << 1];
+
+    if (b[0] == CLIP_SLOT_UNSET || (b[0] >> CLIP_TAG_SHIFT) != tag) {
+        if (b[1] == CLIP_SLOT_UNSET || (b[1] >> CLIP_TAG_SHIFT) != tag) return false;
+
+        // LRU Swap
+        uint32_t t = b[0];
+        b[0] = b[1];
+        b[1] = t;
+        swapLRUCount++;
+    }
+
+    hits++;
+    hitsLegalDepth++;
+
+    int scoreDelta = (board->cells[SCORE_P1] - board->cells[SCORE_P2]) * board->color;
+    const uint32_t lowerField = CLIP_SLOT_LOWER(b[0]);
+    const uint32_t upperField = CLIP_SLOT_UPPER(b[0]);
+    *lower = (lowerField == 0) ? CACHE_NO_LOWER : CLIP_LOWER_VALUE(lowerField) + scoreDelta;
+    *upper = (upperField == 0) ? CACHE_NO_UPPER : CLIP_UPPER_VALUE(upperField) + scoreDelta;
+    *solved = true;
+    return true;
+}
+
+static void migrateClipCache(void *table, uint64_t size, uint32_t sizePow) {
+    uint32_t *old = table;
+    for (uint64_t i = 0; i < (size >> 1); i++) {
+        for (int s = 0; s < 2; s++) {
+            uint32_t slot = old[(i << 1) + s];
+            if (slot == CLIP_SLOT_UNSET) continue;
+
+            Board brd = untranslateBoard_NODEPTH_B48_T32(((uint64_t)(slot >> CLIP_TAG_SHIFT) << (sizePow - 1)) | i);
+            const uint32_t lowerField = CLIP_SLOT_LOWER(slot);
+            const uint32_t upperField = CLIP_SLOT_UPPER(slot);
+
+            if (clipSlotExact(slot)) {
+                migrateEntry(&brd, CLIP_LOWER_VALUE(lowerField), EXACT_BOUND, DEPTH_SOLVED, true, 0);
+                continue;
+            }
+            if (lowerField != 0) migrateEntry(&brd, CLIP_LOWER_VALUE(lowerField), LOWER_BOUND, DEPTH_SOLVED, true, 0);
+            if (upperField != 0) migrateEntry(&brd, CLIP_UPPER_VALUE(upperField), UPPER_BOUND, DEPTH_SOLVED, true, 0);
+        }
+    }
+}
+
+static void collectCacheStatsClip(CacheStats *stats) {
+    stats->cacheSize = cacheSize;
+    stats->entrySize = sizeof(uint32_t);
+    stats->hasDepth = false;
+
+    stats->hits = lastHits;
+    stats->hitsLegal = lastHitsLegalDepth;
+    stats->lruSwaps = lastSwapLRUCount;
+    stats->overwriteImprove = lastSameKeyOverwriteCount;
+    stats->overwriteEvict = lastVictimOverwriteCount;
+    stats->failStones = lastFailedEncodeStoneCount;
+    stats->failRange = lastFailedEncodeValueRange;
+
+    snprintf(stats->modeStr, sizeof(stats->modeStr), "  Mode:       Clip / 48-bit Key / 20-bit Tag (%zu Bytes)", stats->entrySize);
+
+    for (uint64_t i = 0; i < cacheSize; i++) {
+        uint32_t slot = clipCache[i];
+        if (slot == CLIP_SLOT_UNSET) continue;
+
+        stats->setEntries++;
+        if (clipSlotExact(slot)) stats->exactCount++;
+        else if (CLIP_SLOT_UPPER(slot) == 0) stats->lowerCount++;
+        else if (CLIP_SLOT_LOWER(slot) == 0) stats->upperCount++;
+        else stats->windowCount++;
+    }
+}
 
 // --- Internal Logic ---
 
 void resetCacheStats() {
+    lastLeafHits = leafHits;
+    lastLeafStores = leafStores;
+    leafHits = 0;
+    leafStores = 0;
+
+    lastSolvedHits = solvedHits;
+    lastSolvedSpills = solvedSpills;
+    solvedHits = 0;
+    solvedSpills = 0;
+
     lastHits = hits;
     lastHitsLegalDepth = hitsLegalDepth;
     lastSameKeyOverwriteCount = sameKeyOverwriteCount;
@@ -161,54 +607,118 @@ void resetCacheStats() {
     swapLRUCount = 0;
 }
 
-static void freeCurrentCache() {
+static void *detachCurrentCache() {
+    void *table = NULL;
     switch (currentMode) {
         case MODE_ND_B48_T16:
-            freeCacheInternal_NODEPTH_B48_T16();
+            table = detachCacheInternal_NODEPTH_B48_T16();
             break;
         case MODE_ND_B48_T32:
-            freeCacheInternal_NODEPTH_B48_T32();
+            table = detachCacheInternal_NODEPTH_B48_T32();
             break;
         case MODE_ND_B60_T32:
-            freeCacheInternal_NODEPTH_B60_T32();
+            table = detachCacheInternal_NODEPTH_B60_T32();
             break;
         case MODE_D_B48_T16:
-            freeCacheInternal_DEPTH_B48_T16();
+            table = detachCacheInternal_DEPTH_B48_T16();
             break;
         case MODE_D_B48_T32:
-            freeCacheInternal_DEPTH_B48_T32();
+            table = detachCacheInternal_DEPTH_B48_T32();
             break;
         case MODE_D_B60_T32:
-            freeCacheInternal_DEPTH_B60_T32();
+            table = detachCacheInternal_DEPTH_B60_T32();
+            break;
+        case MODE_CLIP_B48_T20:
+            table = detachClipCache();
             break;
         default:
             break;
     }
     currentMode = MODE_DISABLED;
+    return table;
 }
 
-/**
- * Calculates the required mode based on configuration and allocates memory.
- * Returns true on success, or quits the game on impossible config.
- */
-static void reconfigureCache() {
-    if (currentMode != MODE_DISABLED) {
-        freeCurrentCache();
+static bool initCurrentCache() {
+    switch (currentMode) {
+        case MODE_ND_B48_T16:
+            return initCacheInternal_NODEPTH_B48_T16(cacheSize);
+        case MODE_ND_B48_T32:
+            return initCacheInternal_NODEPTH_B48_T32(cacheSize);
+        case MODE_ND_B60_T32:
+            return initCacheInternal_NODEPTH_B60_T32(cacheSize);
+        case MODE_D_B48_T16:
+            return initCacheInternal_DEPTH_B48_T16(cacheSize);
+        case MODE_D_B48_T32:
+            return initCacheInternal_DEPTH_B48_T32(cacheSize);
+        case MODE_D_B60_T32:
+            return initCacheInternal_DEPTH_B60_T32(cacheSize);
+        case MODE_CLIP_B48_T20:
+            return initClipCache(cacheSize);
+        default:
+            return false;
     }
+}
 
-    if (configSizePow <= 2) {
-        cacheSize = 0;
-        cacheSizePow = 0;
+static void migrateCache(CacheDispatchMode mode, void *table, uint64_t size, uint32_t sizePow) {
+    switch (mode) {
+        case MODE_ND_B48_T16:
+            migrateCacheInternal_NODEPTH_B48_T16(table, size, sizePow);
+            break;
+        case MODE_ND_B48_T32:
+            migrateCacheInternal_NODEPTH_B48_T32(table, size, sizePow);
+            break;
+        case MODE_ND_B60_T32:
+            migrateCacheInternal_NODEPTH_B60_T32(table, size, sizePow);
+            break;
+        case MODE_D_B48_T16:
+            migrateCacheInternal_DEPTH_B48_T16(table, size, sizePow);
+            break;
+        case MODE_D_B48_T32:
+            migrateCacheInternal_DEPTH_B48_T32(table, size, sizePow);
+            break;
+        case MODE_D_B60_T32:
+            migrateCacheInternal_DEPTH_B60_T32(table, size, sizePow);
+            break;
+        case MODE_CLIP_B48_T20:
+            migrateClipCache(table, size, sizePow);
+            break;
+        default:
+            break;
+    }
+}
+
+static void migrateEntry(Board *board, int evaluation, int boundType, int depth, bool solved, uint64_t work) {
+    // Depth limited results are meaningless to a no-depth table
+    if (!solved && !isDepthMode(currentMode)) {
+        rehashDroppedEntries++;
+        return;
+    }
+
+    // Boards with too many stones per pit for the new key width
+    uint64_t code;
+    if (!translateBoard(board, &code)) {
+        rehashDroppedEntries++;
         return;
     }
 
-    int indexBits = configSizePow - 1;
+    cacheNodeHash(board, code, evaluation, boundType, depth, solved, work);
+    rehashedEntries++;
+}
+
+/**
+ * Calculates the required mode based on configuration and allocates memory.
+ * Live entries of the previous table are rehashed into the new one where the key allows it.
+ * Quits the game on impossible config.
+ */
+// Layout of the main table for a size, MODE_DISABLED if the key does not fit it
+static CacheDispatchMode selectCacheMode(int sizePow, CacheMode compressMode, bool depth, bool clip, int *keyBits, int *tagBits) {
+    int indexBits = sizePow - 1;
     bool useCompress = false;
 
     // Determine Compression Strategy
-    if (configCompressMode == ALWAYS_COMPRESS) {
+    if (compressMode == ALWAYS_COMPRESS) {
         useCompress = true;
-    } else if (configCompressMode == NEVER_COMPRESS) {
+    } else if (compressMode == NEVER_COMPRESS) {
         useCompress = false;
     } else {
         // AUTO: Default to T32/B60 (No Compress) for best collision resistance.
@@ -221,27 +731,13 @@ static void reconfigureCache() {
         }
     }
 
-    int keyBits = useCompress ? 48 : 60;
+    *keyBits = useCompress ? 48 : 60;
+    *tagBits = *keyBits - indexBits;
 
-    if (configSizePow >= keyBits) {
-        char err[128];
-        snprintf(err, sizeof(err), "Fatal: Cache size 2^%d too large for %d-bit keys.", configSizePow, keyBits);
-        renderOutput(err, CONFIG_PREFIX);
-        quitGame();
-        return;
-    }
+    if (sizePow >= *keyBits || *tagBits > 32) return MODE_DISABLED;
 
-    int tagBitsNeeded = keyBits - indexBits;
     bool useT32 = false;
-
-    if (tagBitsNeeded > 32) {
-        char err[128];
-        snprintf(err, sizeof(err), "Fatal: Cache size 2^%d too small for %d-bit keys. Tag would require %d bits (32 max, need 2^%d min cache).",
-                 configSizePow, keyBits, tagBitsNeeded, keyBits - 32 + 1);
-        renderOutput(err, CONFIG_PREFIX);
-        quitGame();
-        return;
-    } else if (tagBitsNeeded > 16) {
+    if (*tagBits > 16) {
         useT32 = true;
     } else {
         if (useCompress) {
@@ -251,45 +747,95 @@ static void reconfigureCache() {
         }
     }
 
-    if (configDepth) {
-        if (!useCompress) {
-            currentMode = MODE_D_B60_T32;
-        } else {
-            currentMode = useT32 ? MODE_D_B48_T32 : MODE_D_B48_T16;
-        }
-    } else {
-        if (!useCompress) {
-            currentMode = MODE_ND_B60_T32;
-        } else {
-            currentMode = useT32 ? MODE_ND_B48_T32 : MODE_ND_B48_T16;
-        }
+    // Clip searches only need bounds close to the score difference, which fit a denser layout once the tag is short enough
+    if (clip && !depth && sizePow >= CLIP_TABLE_MIN_POW && sizePow < 48) {
+        return MODE_CLIP_B48_T20;
     }
 
-    cacheSize = (uint64_t)1 << configSizePow;
-    cacheSizePow = configSizePow;
+    if (depth) {
+        if (!useCompress) return MODE_D_B60_T32;
+        return useT32 ? MODE_D_B48_T32 : MODE_D_B48_T16;
+    }
 
-    // Initialize selected mode
-    switch (currentMode) {
+    if (!useCompress) return MODE_ND_B60_T32;
+    return useT32 ? MODE_ND_B48_T32 : MODE_ND_B48_T16;
+}
+
+static uint64_t modeEntryBytes(CacheDispatchMode mode) {
+    switch (mode) {
         case MODE_ND_B48_T16:
-            initCacheInternal_NODEPTH_B48_T16(cacheSize);
-            break;
+            return sizeof(Bucket_NODEPTH_B48_T16) / 2;
         case MODE_ND_B48_T32:
-            initCacheInternal_NODEPTH_B48_T32(cacheSize);
-            break;
+            return sizeof(Bucket_NODEPTH_B48_T32) / 2;
         case MODE_ND_B60_T32:
-            initCacheInternal_NODEPTH_B60_T32(cacheSize);
-            break;
+            return sizeof(Bucket_NODEPTH_B60_T32) / 2;
         case MODE_D_B48_T16:
-            initCacheInternal_DEPTH_B48_T16(cacheSize);
-            break;
+            return sizeof(Bucket_DEPTH_B48_T16) / 2;
         case MODE_D_B48_T32:
-            initCacheInternal_DEPTH_B48_T32(cacheSize);
-            break;
+            return sizeof(Bucket_DEPTH_B48_T32) / 2;
         case MODE_D_B60_T32:
-            initCacheInternal_DEPTH_B60_T32(cacheSize);
-            break;
+            return sizeof(Bucket_DEPTH_B60_T32) / 2;
+        case MODE_CLIP_B48_T20:
+            return sizeof(uint32_t);
         default:
-            break;
+            return 0;
+    }
+}
+
+static void reconfigureCache() {
+    CacheDispatchMode oldMode = currentMode;
+    uint64_t oldSize = cacheSize;
+    uint32_t oldSizePow = cacheSizePow;
+    void *oldTable = detachCurrentCache();
+
+    if (configSizePow <= 2) {
+        free(oldTable);
+        cacheSize = 0;
+        cacheSizePow = 0;
+        return;
+    }
+
+    int keyBits = 0;
+    int tagBitsNeeded = 0;
+    CacheDispatchMode mode = selectCacheMode(configSizePow, configCompressMode, configDepth, configClip, &keyBits, &tagBitsNeeded);
+
+    if (mode == MODE_DISABLED && configSizePow >= keyBits) {
+        free(oldTable);
+        char err[128];
+        snprintf(err, sizeof(err), "Fatal: Cache size 2^%d too large for %d-bit keys.", configSizePow, keyBits);
+        renderOutput(err, CONFIG_PREFIX);
+        quitGame();
+        return;
+    }
+
+    if (mode == MODE_DISABLED) {
+        free(oldTable);
+        char err[128];
+        snprintf(err, sizeof(err), "Fatal: Cache size 2^%d too small for %d-bit keys. Tag would require %d bits (32 max, need 2^%d min cache).",
+                 configSizePow, keyBits, tagBitsNeeded, keyBits - 32 + 1);
+        renderOutput(err, CONFIG_PREFIX);
+        quitGame();
+        return;
+    }
+
+    currentMode = mode;
+
+    cacheSize = (uint64_t)1 << configSizePow;
+    cacheSizePow = configSizePow;
+
+    rehashedEntries = 0;
+    rehashDroppedEntries = 0;
+
+    // Initialize selected mode, both tables live at once while rehashing
+    if (!initCurrentCache() && oldTable != NULL) {
+        free(oldTable);
+        oldTable = NULL;
+        initCurrentCache();
+    }
+
+    if (oldTable != NULL) {
+        migrateCache(oldMode, oldTable, oldSize, oldSizePow);
+        free(oldTable);
     }
 
     resetCacheStats();
@@ -297,14 +843,30 @@ static void reconfigureCache() {
 
 // --- Public API ---
 
-void setCacheMode(bool depth, CacheMode compressMode) {
+void setCacheMode(bool depth, const SolverConfig *config) {
     if (getCacheSize() == 0) setCacheSize(DEFAULT_CACHES_SIZE);
 
+    CacheMode compressMode = config->compressCache;
+
+    // Solved entries of a depth table satisfy any no-depth probe and bounded ones never pass
+    // its depth check, so staying in depth mode keeps the table warm across mixed workloads
+    if (config->unifiedCache && !config->clip && !depth && isDepthMode(currentMode)) {
+        depth = true;
+    }
+
+    // Work scores live in the depth field, so the work policy needs a depth layout
+    replaceByWork = (config->replacePolicy == WORK_REPLACE);
+    if (replaceByWork) {
+        depth = true;
+    }
+
     bool sizeChanged = (configSizePow != (int)cacheSizePow);
-    bool modeChanged = (configDepth != depth) || (configCompressMode != compressMode);
+    bool clip = config->clip && clipLayout;
+    bool modeChanged = (configDepth != depth) || (configCompressMode != compressMode) || (configClip != clip);
 
     configDepth = depth;
     configCompressMode = compressMode;
+    configClip = clip;
 
     if (!sizeChanged && !modeChanged) {
         return;
@@ -319,50 +881,289 @@ void setCacheSize(int sizePow) {
     configSizePow = sizePow;
 }
 
-void cacheNodeHash(Board *board, uint64_t boardRep, int evaluation, int boundType, int depth, bool solved) {
+void setClipLayout(bool enabled) {
+    clipLayout = enabled;
+}
+
+bool getClipLayout() {
+    return clipLayout;
+}
+
+void setCacheTraceHook(CacheTraceHook hook) {
+    traceHook = hook;
+}
+
+int planCacheSize(uint64_t budgetBytes, const SolverConfig *config, CacheMode *compressMode, uint64_t *tableBytes) {
+    // Same layout choice setCacheMode makes for the next search
+    bool depth = config->depth != 0 || config->replacePolicy == WORK_REPLACE ||
+                 (config->unifiedCache && !config->clip && isDepthMode(currentMode));
+
+    // The side tables come out of the same budget
+    uint64_t sideBytes = (getSolvedTableSize() + getLeafTableSize()) * sizeof(uint64_t);
+    if (budgetBytes <= sideBytes) return 0;
+    budgetBytes -= sideBytes;
+
+    // More entries beat wider keys, so a compressed layout wins when it allows the next size
+    const CacheMode candidates[] = {NEVER_COMPRESS, ALWAYS_COMPRESS};
+    for (int sizePow = 47; sizePow >= MIN_CACHE_SIZE; sizePow--) {
+        for (int i = 0; i < 2; i++) {
+            if (config->compressCache != AUTO && candidates[i] != config->compressCache) continue;
+
+            int keyBits, tagBits;
+            CacheDispatchMode mode = selectCacheMode(sizePow, candidates[i], depth, config->clip && clipLayout, &keyBits, &tagBits);
+            if (mode == MODE_DISABLED) continue;
+
+            uint64_t bytes = modeEntryBytes(mode) << sizePow;
+            if (bytes > budgetBytes) continue;
+
+            // Keep auto when it lands on the same layout anyway
+            bool autoMatches = selectCacheMode(sizePow, AUTO, depth, config->clip && clipLayout, &keyBits, &tagBits) == mode;
+            *compressMode = (config->compressCache == AUTO && autoMatches) ? AUTO : candidates[i];
+            *tableBytes = bytes + sideBytes;
+            return sizePow;
+        }
+    }
+
+    return 0;
+}
+
+static void cacheNodeHashMain(Board *board, uint64_t boardRep, int evaluation, int boundType, int depth, bool solved, uint64_t work) {
     switch (currentMode) {
         case MODE_ND_B48_T16:
-            cacheNodeHash_NODEPTH_B48_T16(board, boardRep, evaluation, boundType, depth, solved);
+            cacheNodeHash_NODEPTH_B48_T16(board, boardRep, evaluation, boundType, depth, solved, work);
             break;
         case MODE_ND_B48_T32:
-            cacheNodeHash_NODEPTH_B48_T32(board, boardRep, evaluation, boundType, depth, solved);
+            cacheNodeHash_NODEPTH_B48_T32(board, boardRep, evaluation, boundType, depth, solved, work);
             break;
         case MODE_ND_B60_T32:
-            cacheNodeHash_NODEPTH_B60_T32(board, boardRep, evaluation, boundType, depth, solved);
+            cacheNodeHash_NODEPTH_B60_T32(board, boardRep, evaluation, boundType, depth, solved, work);
             break;
         case MODE_D_B48_T16:
-            cacheNodeHash_DEPTH_B48_T16(board, boardRep, evaluation, boundType, depth, solved);
+            cacheNodeHash_DEPTH_B48_T16(board, boardRep, evaluation, boundType, depth, solved, work);
             break;
         case MODE_D_B48_T32:
-            cacheNodeHash_DEPTH_B48_T32(board, boardRep, evaluation, boundType, depth, solved);
+            cacheNodeHash_DEPTH_B48_T32(board, boardRep, evaluation, boundType, depth, solved, work);
             break;
         case MODE_D_B60_T32:
-            cacheNodeHash_DEPTH_B60_T32(board, boardRep, evaluation, boundType, depth, solved);
+            cacheNodeHash_DEPTH_B60_T32(board, boardRep, evaluation, boundType, depth, solved, work);
+            break;
+        case MODE_CLIP_B48_T20:
+            cacheNodeHashClip(board, boardRep, evaluation, boundType);
             break;
         default:
             break;
     }
 }
 
-bool getCachedValueHash(Board *board, uint64_t hashValue, int currentDepth, int *evaluation, int *boundType, bool *solved) {
+void cacheNodeHash(Board *board, uint64_t boardRep, int evaluation, int boundType, int depth, bool solved, uint64_t work) {
+    if (traceHook) traceHook(boardRep, true);
+
+    if (leafTableRoute(board, depth)) {
+        uint64_t code;
+        if (translateBoard_DEPTH_B48_T32(board, &code)) {
+            int scoreDelta = (board->cells[SCORE_P1] - board->cells[SCORE_P2]) * board->color;
+            int relative = evaluation - scoreDelta;
+
+            if (relative > CACHE_VAL_MAX || relative < CACHE_VAL_MIN) {
+                failedEncodeValueRange++;
+                return;
+            }
+
+            // No-depth searches always run to the end
+            if (!isDepthMode(currentMode)) solved = true;
+            uint16_t storedDepth = solved ? ENTRY_DEPTH_SOLVED : min(depth, ENTRY_DEPTH_MAX);
+
+            storeLeafCode(code, PACK_VALUE(relative, boundType), storedDepth);
+            return;
+        }
+    }
+
+    if (solved && solvedTableActive()) {
+        uint64_t code;
+        if (translateBoard_DEPTH_B60_T32(board, &code)) {
+            int scoreDelta = (board->cells[SCORE_P1] - board->cells[SCORE_P2]) * board->color;
+            int relative = evaluation - scoreDelta;
+
+            if (relative > CACHE_VAL_MAX || relative < CACHE_VAL_MIN) {
+                failedEncodeValueRange++;
+                return;
+            }
+
+            storeSolvedCode(code, PACK_VALUE(relative, boundType));
+            return;
+        }
+    }
+
+    cacheNodeHashMain(board, boardRep, evaluation, boundType, depth, solved, work);
+}
+
+bool getCachedValueHash(Board *board, uint64_t hashValue, int currentDepth, int *lower, int *upper, bool *solved) {
+    if (traceHook) traceHook(hashValue, false);
+
+    if (leafTableRoute(board, currentDepth)) {
+        uint64_t code;
+        if (translateBoard_DEPTH_B48_T32(board, &code)) {
+            uint64_t slot;
+            if (!probeLeafCode(code, &slot)) return false;
+
+            uint16_t storedDepth = leafSlotDepth(slot);
+            if (storedDepth < min(currentDepth, ENTRY_DEPTH_MAX)) return false;
+
+            int16_t value = (int16_t)(slot & 0xFFFF);
+            int scoreDelta = (board->cells[SCORE_P1] - board->cells[SCORE_P2]) * board->color;
+            int evaluation = UNPACK_VALUE(value) + scoreDelta;
+            int boundType = UNPACK_BOUND(value);
+            *lower = (boundType == UPPER_BOUND) ? CACHE_NO_LOWER : evaluation;
+            *upper = (boundType == LOWER_BOUND) ? CACHE_NO_UPPER : evaluation;
+            *solved = (storedDepth == ENTRY_DEPTH_SOLVED);
+            leafHits++;
+            return true;
+        }
+    }
+
+    if (solvedTableActive()) {
+        uint64_t code;
+        int16_t value;
+        if (translateBoard_DEPTH_B60_T32(board, &code) && probeSolvedCode(code, &value)) {
+            int scoreDelta = (board->cells[SCORE_P1] - board->cells[SCORE_P2]) * board->color;
+            int evaluation = UNPACK_VALUE(value) + scoreDelta;
+            int boundType = UNPACK_BOUND(value);
+            *lower = (boundType == UPPER_BOUND) ? CACHE_NO_LOWER : evaluation;
+            *upper = (boundType == LOWER_BOUND) ? CACHE_NO_UPPER : evaluation;
+            *solved = true;
+            solvedHits++;
+            return true;
+        }
+    }
+
     switch (currentMode) {
         case MODE_ND_B48_T16:
-            return getCachedValueHash_NODEPTH_B48_T16(board, hashValue, currentDepth, evaluation, boundType, solved);
+            return getCachedValueHash_NODEPTH_B48_T16(board, hashValue, currentDepth, lower, upper, solved);
         case MODE_ND_B48_T32:
-            return getCachedValueHash_NODEPTH_B48_T32(board, hashValue, currentDepth, evaluation, boundType, solved);
+            return getCachedValueHash_NODEPTH_B48_T32(board, hashValue, currentDepth, lower, upper, solved);
         case MODE_ND_B60_T32:
-            return getCachedValueHash_NODEPTH_B60_T32(board, hashValue, currentDepth, evaluation, boundType, solved);
+            return getCachedValueHash_NODEPTH_B60_T32(board, hashValue, currentDepth, lower, upper, solved);
         case MODE_D_B48_T16:
-            return getCachedValueHash_DEPTH_B48_T16(board, hashValue, currentDepth, evaluation, boundType, solved);
+            return getCachedValueHash_DEPTH_B48_T16(board, hashValue, currentDepth, lower, upper, solved);
         case MODE_D_B48_T32:
-            return getCachedValueHash_DEPTH_B48_T32(board, hashValue, currentDepth, evaluation, boundType, solved);
+            return getCachedValueHash_DEPTH_B48_T32(board, hashValue, currentDepth, lower, upper, solved);
         case MODE_D_B60_T32:
-            return getCachedValueHash_DEPTH_B60_T32(board, hashValue, currentDepth, evaluation, boundType, solved);
+            return getCachedValueHash_DEPTH_B60_T32(board, hashValue, currentDepth, lower, upper, solved);
+        case MODE_CLIP_B48_T20:
+            return getCachedValueHashClip(board, hashValue, lower, upper, solved);
         default:
             return false;
     }
 }
 
+bool setSolvedTableSize(int sizePow) {
+    if (sizePow == 0) {
+        free(solvedTable);
+        solvedTable = NULL;
+        solvedSizePow = 0;
+        return true;
+    }
+
+    if (sizePow < SOLVED_TABLE_MIN_POW || sizePow > SOLVED_TABLE_MAX_POW) return false;
+    if (solvedTable != NULL && (uint32_t)sizePow == solvedSizePow) return true;
+
+    uint64_t *newTable = malloc(sizeof(uint64_t) * 2 * solvedBucketCount(sizePow));
+    if (newTable == NULL) return false;
+
+    uint64_t *oldTable = solvedTable;
+    uint32_t oldSizePow = solvedSizePow;
+
+    solvedTable = newTable;
+    solvedSizePow = sizePow;
+    clearSolvedTable();
+
+    if (oldTable != NULL) {
+        migrateSolvedTable(oldTable, oldSizePow);
+        free(oldTable);
+    }
+    return true;
+}
+
+bool setLeafTableSize(int sizePow) {
+    if (sizePow != 0 && (sizePow < LEAF_TABLE_MIN_POW || sizePow > LEAF_TABLE_MAX_POW)) return false;
+
+    free(leafTable);
+    leafTable = NULL;
+    leafSizePow = 0;
+    if (sizePow == 0) return true;
+
+    // Near-leaf results are cheap to recompute, a resize simply starts empty
+    leafTable = malloc(sizeof(uint64_t) * 2 * leafBucketCount(sizePow));
+    if (leafTable == NULL) return false;
+
+    leafSizePow = sizePow;
+    clearLeafTable();
+    return true;
+}
+
+uint64_t getLeafTableSize() {
+    if (leafTable == NULL) return 0;
+    return leafBucketCount(leafSizePow) << 1;
+}
+
+uint64_t getSolvedTableSize() {
+    if (solvedTable == NULL) return 0;
+    return solvedBucketCount(solvedSizePow) << 1;
+}
+
+static bool writeSolvedTable(FILE *f, void *context) {
+    (void)context;
+
+    SolvedTableHeader header = {SOLVED_TABLE_MAGIC, SOLVED_TABLE_VERSION, solvedSizePow, (uint32_t)getMoveFunction()};
+    uint64_t slots = solvedBucketCount(solvedSizePow) << 1;
+
+    return fwrite(&header, sizeof(header), 1, f) == 1 &&
+           fwrite(solvedTable, sizeof(uint64_t), slots, f) == slots;
+}
+
+// A failed or interrupted save keeps the previous file
+bool saveSolvedTable(const char *path) {
+    if (solvedTable == NULL) return false;
+    return writeFileReplacing(path, writeSolvedTable, NULL);
+}
+
+/**
+ * Merges a saved table into the current one, rehashing when the sizes differ.
+ * Without a configured table the saved size is adopted.
+ */
+bool loadSolvedTable(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) return false;
+
+    SolvedTableHeader header;
+    if (fread(&header, sizeof(header), 1, f) != 1 ||
+        header.magic != SOLVED_TABLE_MAGIC || header.version != SOLVED_TABLE_VERSION ||
+        header.moveFunction != (uint32_t)getMoveFunction() ||
+        header.sizePow < SOLVED_TABLE_MIN_POW || header.sizePow > SOLVED_TABLE_MAX_POW) {
+        fclose(f);
+        return false;
+    }
+
+    uint64_t slots = solvedBucketCount(header.sizePow) << 1;
+    uint64_t *table = malloc(sizeof(uint64_t) * slots);
+    if (table == NULL || fread(table, sizeof(uint64_t), slots, f) != slots) {
+        free(table);
+        fclose(f);
+        return false;
+    }
+    fclose(f);
+
+    if (solvedTable == NULL) {
+        solvedTable = table;
+        solvedSizePow = header.sizePow;
+        return true;
+    }
+
+    migrateSolvedTable(table, header.sizePow);
+    free(table);
+    return true;
+}
+
 uint64_t getCacheSize() {
     if (configSizePow <= 2) return 0;
     return (uint64_t)1 << configSizePow;
@@ -373,29 +1174,15 @@ void stepCache() {
 }
 
 void invalidateCache() {
+    clearSolvedTable();
+    clearLeafTable();
+
+    // Entries carried over by the last reconfiguration are gone now
+    rehashedEntries = 0;
+    rehashDroppedEntries = 0;
+
     if (currentMode != MODE_DISABLED && cacheSize > 0) {
-        switch (currentMode) {
-            case MODE_ND_B48_T16:
-                initCacheInternal_NODEPTH_B48_T16(cacheSize);
-                break;
-            case MODE_ND_B48_T32:
-                initCacheInternal_NODEPTH_B48_T32(cacheSize);
-                break;
-            case MODE_ND_B60_T32:
-                initCacheInternal_NODEPTH_B60_T32(cacheSize);
-                break;
-            case MODE_D_B48_T16:
-                initCacheInternal_DEPTH_B48_T16(cacheSize);
-                break;
-            case MODE_D_B48_T32:
-                initCacheInternal_DEPTH_B48_T32(cacheSize);
-                break;
-            case MODE_D_B60_T32:
-                initCacheInternal_DEPTH_B60_T32(cacheSize);
-                break;
-            default:
-                break;
-        }
+        initCurrentCache();
         resetCacheStats();
     }
 }
@@ -425,9 +1212,35 @@ void fillCacheStats(CacheStats *stats, bool calcFrag, bool calcStoneDist, bool c
         case MODE_D_B60_T32:
             collectCacheStats_DEPTH_B60_T32(stats, calcFrag, calcStoneDist, calcDepthDist);
             break;
+        case MODE_CLIP_B48_T20:
+            collectCacheStatsClip(stats);
+            break;
         default:
             break;
     }
+
+    stats->rehashed = rehashedEntries;
+    stats->rehashDropped = rehashDroppedEntries;
+
+    if (solvedTable != NULL) {
+        uint64_t slots = solvedBucketCount(solvedSizePow) << 1;
+        stats->solvedTableSize = slots;
+        for (uint64_t i = 0; i < slots; i++) {
+            if (solvedTable[i] != SOLVED_SLOT_UNSET) stats->solvedTableEntries++;
+        }
+        stats->solvedTableHits = lastSolvedHits;
+        stats->solvedTableSpills = lastSolvedSpills;
+    }
+
+    if (leafTable != NULL) {
+        uint64_t slots = leafBucketCount(leafSizePow) << 1;
+        stats->leafTableSize = slots;
+        for (uint64_t i = 0; i < slots; i++) {
+            if (leafTable[i] != LEAF_SLOT_UNSET) stats->leafTableEntries++;
+        }
+        stats->leafTableHits = lastLeafHits;
+        stats->leafTableStores = lastLeafStores;
+    }
 }
 
 void renderCacheStats(bool calcFrag, bool calcStoneDist, bool calcDepthDist) {
@@ -461,6 +1274,8 @@ bool translateBoard(Board *board, uint64_t *code) {
         case MODE_D_B60_T32:
             return translateBoard_DEPTH_B60_T32(board, code);
             break;
+        case MODE_CLIP_B48_T20:
+            return translateBoard_NODEPTH_B48_T32(board, code);
         default:
             return false;
     }
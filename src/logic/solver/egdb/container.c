@@ -0,0 +1,327 @@
+/**
+ * Copyright (c) Alexander Kurtz 2026
+ */
+
+#include "logic/solver/egdb/container.h"
+#include "logic/solver/egdb/core.h"
+#include "logic/solver/egdb/common.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32) && !defined(WEB_BUILD)
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define EGDB_CONTAINER_MMAP
+#endif
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t flags;
+    uint32_t encoding;
+    uint32_t minStones;
+    uint32_t maxStones;
+    uint32_t blockSize;
+    uint32_t alignment;
+    uint64_t fileSize;
+    uint64_t indexHash;
+    uint64_t headerHash;
+} EGDBContainerHeader;
+
+typedef struct {
+    uint64_t offset;
+    uint64_t positions;
+    uint64_t hashOffset;
+    uint64_t blocks;
+} EGDBContainerLayer;
+
+static uint8_t *containerData = NULL;
+static uint64_t containerSize = 0;
+static const EGDBContainerHeader *containerHeader = NULL;
+static const EGDBContainerLayer *containerIndex = NULL;
+
+static inline uint64_t alignUp(uint64_t value) {
+    return (value + EGDB_CONTAINER_ALIGNMENT - 1) / EGDB_CONTAINER_ALIGNMENT * EGDB_CONTAINER_ALIGNMENT;
+}
+
+static inline uint64_t blockCount(uint64_t positions) {
+    return (positions + EGDB_CONTAINER_BLOCK_SIZE - 1) / EGDB_CONTAINER_BLOCK_SIZE;
+}
+
+void egdbContainerPath(char *buffer, size_t size, bool is_avalanche) {
+    snprintf(buffer, size, "EGDB/egdb%s.edb", is_avalanche ? "_av" : "");
+}
+
+static void releaseContainer() {
+    if (!containerData) return;
+
+    // Layers served from the mapping would dangle, the ones above them are unusable as well
+    for (int s = 1; s <= EGDB_MAX_STONES; s++) {
+        if (!egdbContainerOwns(egdb_tables[s])) continue;
+        egdb_tables[s] = NULL;
+        if (loaded_egdb_max_stones >= s) loaded_egdb_max_stones = s - 1;
+    }
+
+#ifdef EGDB_CONTAINER_MMAP
+    munmap(containerData, containerSize);
+#else
+    free(containerData);
+#endif
+
+    containerData = NULL;
+    containerSize = 0;
+    containerHeader = NULL;
+    containerIndex = NULL;
+}
+
+void egdbContainerClose() {
+    releaseContainer();
+}
+
+static bool mapContainer(const char *path) {
+#ifdef EGDB_CONTAINER_MMAP
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+
+    void *mapped = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) return false;
+
+    containerData = mapped;
+    containerSize = (uint64_t)st.st_size;
+    return true;
+#else
+    FILE *f = fopen(path, "rb");
+    if (!f) return false;
+
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    containerData = size > 0 ? malloc((size_t)size) : NULL;
+    if (!containerData || fread(containerData, 1, (size_t)size, f) != (size_t)size) {
+        free(containerData);
+        containerData = NULL;
+        fclose(f);
+        return false;
+    }
+
+    fclose(f);
+    containerSize = (uint64_t)size;
+    return true;
+#endif
+}
+
+static int rejectContainer(char *reason, size_t reasonSize, const char *message) {
+    snprintf(reason, reasonSize, "%s", message);
+    releaseContainer();
+    return -1;
+}
+
+int egdbContainerOpen(bool is_avalanche, char *reason, size_t reasonSize) {
+    releaseContainer();
+
+    char path[256];
+    egdbContainerPath(path, sizeof(path), is_avalanche);
+    if (!mapContainer(path)) return 0;
+
+    // --- Header ---
+    if (containerSize < sizeof(EGDBContainerHeader)) return rejectContainer(reason, reasonSize, "truncated header");
+
+    const EGDBContainerHeader *header = (const EGDBContainerHeader *)containerData;
+    if (header->magic != EGDB_CONTAINER_MAGIC) return rejectContainer(reason, reasonSize, "not an EGDB container");
+    if (header->version != EGDB_CONTAINER_VERSION) return rejectContainer(reason, reasonSize, "unsupported version");
+    if (egdbHashBytes(header, offsetof(EGDBContainerHeader, headerHash)) != header->headerHash) {
+        return rejectContainer(reason, reasonSize, "damaged header");
+    }
+    if (((header->flags & EGDB_CONTAINER_AVALANCHE) != 0) != is_avalanche) {
+        return rejectContainer(reason, reasonSize, "built for the other game mode");
+    }
+    if (header->encoding != EGDB_ENCODING_SCORE_I8) return rejectContainer(reason, reasonSize, "unknown value encoding");
+    if (header->minStones != 1 || header->maxStones < 1 || header->maxStones > EGDB_MAX_STONES ||
+        header->blockSize != EGDB_CONTAINER_BLOCK_SIZE || header->alignment != EGDB_CONTAINER_ALIGNMENT) {
+        return rejectContainer(reason, reasonSize, "unsupported layout");
+    }
+    if (header->fileSize != containerSize) return rejectContainer(reason, reasonSize, "truncated file");
+
+    // --- Index ---
+    const uint64_t layers = header->maxStones - header->minStones + 1;
+    const uint64_t indexBytes = layers * sizeof(EGDBContainerLayer);
+    if (sizeof(EGDBContainerHeader) + indexBytes > containerSize) return rejectContainer(reason, reasonSize, "truncated index");
+
+    const EGDBContainerLayer *index = (const EGDBContainerLayer *)(containerData + sizeof(EGDBContainerHeader));
+    if (egdbHashBytes(index, indexBytes) != header->indexHash) return rejectContainer(reason, reasonSize, "damaged index");
+
+    // --- Payloads ---
+    for (uint64_t l = 0; l < layers; l++) {
+        const EGDBContainerLayer *layer = &index[l];
+        if (layer->offset % EGDB_CONTAINER_ALIGNMENT != 0 || layer->blocks != blockCount(layer->positions) ||
+            layer->offset > containerSize || layer->positions > containerSize - layer->offset ||
+            layer->hashOffset > containerSize || layer->blocks > (containerSize - layer->hashOffset) / sizeof(uint64_t)) {
+            return rejectContainer(reason, reasonSize, "layer outside of the file");
+        }
+    }
+
+    containerHeader = header;
+    containerIndex = index;
+    return (int)header->maxStones;
+}
+
+bool egdbContainerVerify(uint64_t *blocks, char *reason, size_t reasonSize) {
+    *blocks = 0;
+    if (!containerHeader) {
+        snprintf(reason, reasonSize, "no container mapped");
+        return false;
+    }
+
+    const uint64_t layers = containerHeader->maxStones - containerHeader->minStones + 1;
+    for (uint64_t l = 0; l < layers; l++) {
+        const EGDBContainerLayer *layer = &containerIndex[l];
+        const uint8_t *payload = containerData + layer->offset;
+        const uint64_t *hashes = (const uint64_t *)(containerData + layer->hashOffset);
+
+        for (uint64_t b = 0; b < layer->blocks; b++, (*blocks)++) {
+            uint64_t start = b * EGDB_CONTAINER_BLOCK_SIZE;
+            uint64_t bytes = min(layer->positions - start, (uint64_t)EGDB_CONTAINER_BLOCK_SIZE);
+            if (egdbHashBytes(payload + start, bytes) != hashes[b]) {
+                snprintf(reason, reasonSize, "damaged block %" PRIu64 " in layer %" PRIu64, b, l + containerHeader->minStones);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int8_t *egdbContainerLayer(int s, uint64_t *positions) {
+    if (!containerHeader || s < (int)containerHeader->minStones || s > (int)containerHeader->maxStones) return NULL;
+
+    const EGDBContainerLayer *layer = &containerIndex[s - containerHeader->minStones];
+    *positions = layer->positions;
+    return (int8_t *)(containerData + layer->offset);
+}
+
+bool egdbContainerOwns(const int8_t *table) {
+    return containerData && table &&
+           (const uint8_t *)table >= containerData && (const uint8_t *)table < containerData + containerSize;
+}
+
+static bool writeZeros(FILE *f, uint64_t bytes) {
+    static const uint8_t zeros[EGDB_CONTAINER_ALIGNMENT] = {0};
+    while (bytes > 0) {
+        size_t n = (size_t)min(bytes, (uint64_t)sizeof(zeros));
+        if (fwrite(zeros, 1, n, f) != n) return false;
+        bytes -= n;
+    }
+    return true;
+}
+
+typedef struct {
+    const EGDBContainerHeader *header;
+    const EGDBContainerLayer *index;
+    uint64_t *const *hashes;
+    uint64_t layers;
+    EGDBLayerReader reader;
+    int8_t *buffer;
+} ContainerFile;
+
+static bool writeContainerContents(FILE *f, void *context) {
+    const ContainerFile *file = context;
+    const EGDBContainerLayer *index = file->index;
+
+    bool ok = fwrite(file->header, sizeof(EGDBContainerHeader), 1, f) == 1 &&
+              fwrite(index, sizeof(EGDBContainerLayer), file->layers, f) == file->layers;
+    uint64_t written = sizeof(EGDBContainerHeader) + file->layers * sizeof(EGDBContainerLayer);
+
+    for (uint64_t l = 0; ok && l < file->layers; l++) {
+        ok = fwrite(file->hashes[l], sizeof(uint64_t), index[l].blocks, f) == index[l].blocks;
+        written += index[l].blocks * sizeof(uint64_t);
+    }
+    for (uint64_t l = 0; ok && l < file->layers; l++) {
+        ok = writeZeros(f, index[l].offset - written);
+        written = index[l].offset;
+
+        for (uint64_t b = 0; ok && b < index[l].blocks; b++) {
+            uint64_t start = b * EGDB_CONTAINER_BLOCK_SIZE;
+            uint64_t count = min(index[l].positions - start, (uint64_t)EGDB_CONTAINER_BLOCK_SIZE);
+            ok = file->reader((int)l + 1, start, file->buffer, count) && fwrite(file->buffer, 1, count, f) == count;
+            written += count;
+        }
+    }
+    return ok;
+}
+
+bool egdbContainerWrite(int max_stones, bool is_avalanche, const uint64_t *sizes, EGDBLayerReader reader) {
+    if (max_stones < 1 || max_stones > EGDB_MAX_STONES) return false;
+
+    const uint64_t layers = (uint64_t)max_stones;
+    EGDBContainerLayer *index = calloc(layers, sizeof(EGDBContainerLayer));
+    uint64_t **hashes = calloc(layers, sizeof(uint64_t *));
+    int8_t *buffer = malloc(EGDB_CONTAINER_BLOCK_SIZE);
+    bool ok = index && hashes && buffer;
+
+    // --- Layout: header, index, hashes, then aligned payloads ---
+    uint64_t offset = sizeof(EGDBContainerHeader) + layers * sizeof(EGDBContainerLayer);
+    for (uint64_t l = 0; ok && l < layers; l++) {
+        index[l].positions = sizes[l + 1];
+        index[l].blocks = blockCount(sizes[l + 1]);
+        index[l].hashOffset = offset;
+        offset += index[l].blocks * sizeof(uint64_t);
+
+        hashes[l] = malloc(index[l].blocks * sizeof(uint64_t) + 1);
+        if (!hashes[l]) ok = false;
+    }
+    for (uint64_t l = 0; ok && l < layers; l++) {
+        offset = alignUp(offset);
+        index[l].offset = offset;
+        offset += index[l].positions;
+    }
+    const uint64_t fileSize = offset;
+
+    // --- Block hashes, a first pass so the file can be written front to back ---
+    for (uint64_t l = 0; ok && l < layers; l++) {
+        for (uint64_t b = 0; ok && b < index[l].blocks; b++) {
+            uint64_t start = b * EGDB_CONTAINER_BLOCK_SIZE;
+            uint64_t count = min(index[l].positions - start, (uint64_t)EGDB_CONTAINER_BLOCK_SIZE);
+            ok = reader((int)l + 1, start, buffer, count);
+            if (ok) hashes[l][b] = egdbHashBytes(buffer, count);
+        }
+    }
+
+    EGDBContainerHeader header = {
+        .magic = EGDB_CONTAINER_MAGIC,
+        .version = EGDB_CONTAINER_VERSION,
+        .flags = is_avalanche ? EGDB_CONTAINER_AVALANCHE : 0,
+        .encoding = EGDB_ENCODING_SCORE_I8,
+        .minStones = 1,
+        .maxStones = (uint32_t)max_stones,
+        .blockSize = EGDB_CONTAINER_BLOCK_SIZE,
+        .alignment = EGDB_CONTAINER_ALIGNMENT,
+        .fileSize = fileSize};
+    if (ok) {
+        header.indexHash = egdbHashBytes(index, layers * sizeof(EGDBContainerLayer));
+        header.headerHash = egdbHashBytes(&header, offsetof(EGDBContainerHeader, headerHash));
+    }
+
+    char path[256];
+    egdbContainerPath(path, sizeof(path), is_avalanche);
+
+    ContainerFile file = {&header, index, hashes, layers, reader, buffer};
+    ok = ok && writeFileReplacing(path, writeContainerContents, &file);
+
+    for (uint64_t l = 0; hashes && l < layers; l++) {
+        free(hashes[l]);
+    }
+    free(hashes);
+    free(index);
+    free(buffer);
+    return ok;
+}
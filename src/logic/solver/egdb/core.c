@@ -5,14 +5,51 @@
  */
 
 #include "logic/solver/egdb/core.h"
+#include "logic/solver/egdb/container.h"
+#include "logic/solver/egdb/common.h"
+
+#ifndef WEB_BUILD
+#include <pthread.h>
+#endif
 
 uint64_t ways[EGDB_MAX_STONES + 1][13];
+
+// Same counts indexed [pits][stones], so ranking and unranking read contiguous rows
+static uint64_t waysByPits[13][EGDB_MAX_STONES + 1];
 int8_t *egdb_tables[EGDB_MAX_STONES + 1] = {NULL};
 
 int loaded_egdb_max_stones = 0;
 bool loaded_egdb_is_avalanche = false;
 int egdb_total_stones_configured = 48;
 uint64_t egdb_hits = 0;
+static uint64_t egdb_bound_hits = 0;
+
+// Sign-only layers, packed four positions per byte
+static uint8_t *wdl_tables[EGDB_MAX_STONES + 1] = {NULL};
+int loaded_wdl_max_stones = 0;
+static bool loaded_wdl_is_avalanche = false;
+static uint64_t wdl_hits = 0;
+
+// Generation threads, 0 uses every core
+static int egdb_threads = 0;
+
+void setEGDBThreads(int threads) {
+    egdb_threads = threads;
+}
+
+int getEGDBThreads() {
+    return egdb_threads;
+}
+
+static int egdb_checkpoint_interval = EGDB_DEFAULT_CHECKPOINT_INTERVAL;
+
+void setEGDBCheckpointInterval(int seconds) {
+    egdb_checkpoint_interval = seconds;
+}
+
+int getEGDBCheckpointInterval() {
+    return egdb_checkpoint_interval;
+}
 
 void configureStoneCountEGDB(int totalStones) {
     egdb_total_stones_configured = totalStones;
@@ -35,6 +72,12 @@ static void initWaysTable() {
         }
     }
 
+    for (int p = 1; p <= 12; p++) {
+        for (int s = 0; s <= EGDB_MAX_STONES; s++) {
+            waysByPits[p][s] = ways[s][p];
+        }
+    }
+
     initialized = true;
     egdb_mem_init();
 }
@@ -71,23 +114,22 @@ static inline uint64_t getEGDBIndex(const Board *board, int stones) {
         rel[11] = board->cells[5];
     }
 
+    // Pit i adds the boards whose pit i holds fewer stones, ways[n][p] - ways[n - k][p]
+    // An empty pit adds 0, so all 11 pits run without branches and the loop fully unrolls
     uint64_t index = 0;
-    int pitsLeft = 12;
+    int n = stones;
 
     for (int i = 0; i < 11; i++) {
-        int s = rel[i];
-        if (s > 0) {
-            index += ways[stones][pitsLeft] - ways[stones - s][pitsLeft];
-            stones -= s;
-            if (stones == 0) break;
-        }
-        pitsLeft--;
+        const uint64_t *row = waysByPits[12 - i];
+        index += row[n] - row[n - rel[i]];
+        n -= rel[i];
     }
 
     return index;
 }
 
-bool EGDB_probe(Board *board, int *score) {
+// Layer and index of a board, false if no loaded layer of the current mode holds it
+static inline bool locateEGDBPosition(const Board *board, int *stones, uint64_t *idx) {
     bool current_is_avalanche = (getMoveFunction() != CLASSIC_MOVE);
     if (current_is_avalanche != loaded_egdb_is_avalanche) {
         return false;
@@ -99,20 +141,23 @@ bool EGDB_probe(Board *board, int *score) {
         return false;
     }
 
-    // 3. Pass stonesLeft down here
-    uint64_t idx = getEGDBIndex(board, stonesLeft);
+    *stones = stonesLeft;
+    *idx = getEGDBIndex(board, stonesLeft);
+    return true;
+}
+
+static inline bool probeEGDBValue(const Board *board, int stones, uint64_t idx, int *score) {
     int8_t futureVal;
 
-    if (!egdb_mem_probe(stonesLeft, idx, &futureVal)) {
+    if (!egdb_mem_probe(stones, idx, &futureVal)) {
         return false;
     }
 
-    if (futureVal == EGDB_UNCOMPUTED || futureVal == EGDB_VISITING) {
+    if (futureVal == EGDB_UNCOMPUTED) {
         return false;
     }
 
-    // 4. Branchless Math: board->color is 1 or -1.
-    // This perfectly toggles the subtraction direction without an if/else ternary!
+    // board->color is 1 or -1, which toggles the subtraction direction without a branch
     int currentDiff = board->color * (board->cells[SCORE_P1] - board->cells[SCORE_P2]);
 
     *score = currentDiff + futureVal;
@@ -121,24 +166,73 @@ bool EGDB_probe(Board *board, int *score) {
     return true;
 }
 
+bool EGDB_probe(Board *board, int *score) {
+    int stones;
+    uint64_t idx;
+    if (!locateEGDBPosition(board, &stones, &idx)) return false;
+
+    return probeEGDBValue(board, stones, idx, score);
+}
+
+bool EGDB_probe_bound(Board *board, int alpha, int beta, int *score) {
+    int stones;
+    uint64_t idx;
+    if (!locateEGDBPosition(board, &stones, &idx)) return false;
+
+    // A whole block on one side of the window decides the node without decoding the block
+    int8_t lower, upper;
+    if (egdb_mem_probe_bound(stones, idx, &lower, &upper)) {
+        int currentDiff = board->color * (board->cells[SCORE_P1] - board->cells[SCORE_P2]);
+
+        if (currentDiff + lower >= beta) {
+            *score = currentDiff + lower;
+            egdb_bound_hits++;
+            return true;
+        }
+        if (currentDiff + upper <= alpha) {
+            *score = currentDiff + upper;
+            egdb_bound_hits++;
+            return true;
+        }
+    }
+
+    return probeEGDBValue(board, stones, idx, score);
+}
+
+void summarizeEGDBBlocks(const int8_t *values, uint64_t size, uint64_t block_size, int8_t *bounds) {
+    for (uint64_t start = 0, block = 0; start < size; start += block_size, block++) {
+        uint64_t end = min(start + block_size, size);
+        int8_t lower = values[start];
+        int8_t upper = values[start];
+
+        for (uint64_t i = start + 1; i < end; i++) {
+            if (values[i] < lower) lower = values[i];
+            if (values[i] > upper) upper = values[i];
+        }
+
+        bounds[2 * block] = lower;
+        bounds[2 * block + 1] = upper;
+    }
+}
+
 static void unhashToBoard(uint64_t index, int stones, Board *board) {
     uint8_t rel[12];
     int stonesLeft = stones;
-    int pitsLeft = 12;
     uint64_t temp_idx = index;
 
     // Reconstruct normalized stone distribution
+    // Pits hold stones / 12 on average, so a short scan over one contiguous row beats a binary search
     for (int i = 0; i < 11; i++) {
+        const uint64_t *row = waysByPits[11 - i];
         int cnt = 0;
         while (cnt <= stonesLeft) {
-            uint64_t w = ways[stonesLeft - cnt][pitsLeft - 1];
+            uint64_t w = row[stonesLeft - cnt];
             if (temp_idx < w) break;
             temp_idx -= w;
             cnt++;
         }
         rel[i] = cnt;
         stonesLeft -= cnt;
-        pitsLeft--;
     }
     rel[11] = stonesLeft;
 
@@ -151,74 +245,561 @@ static void unhashToBoard(uint64_t index, int stones, Board *board) {
         board->cells[i + 7] = rel[i + 6];
 }
 
-static int8_t crunch(int stones, uint64_t index, Board *board) {
-    // Return early if already visited or computed
-    if (egdb_tables[stones][index] == EGDB_VISITING) return 0;
-    if (egdb_tables[stones][index] != EGDB_UNCOMPUTED) return egdb_tables[stones][index];
+// Board of unhashToBoard for the index of a board, the side to move becomes player 1
+static inline void normalizeEGDBBoard(const Board *board, Board *normalized) {
+    const int own = (board->color == 1) ? 0 : 7;
+    const int other = 7 - own;
 
-    int best_score = -127;
-    egdb_tables[stones][index] = EGDB_VISITING;
-    bool can_move = false;
+    memset(normalized, 0, sizeof(Board));
+    normalized->color = 1;
+    for (int i = 0; i <= 5; i++) {
+        normalized->cells[i] = board->cells[i + own];
+        normalized->cells[i + 7] = board->cells[i + other];
+    }
+}
 
-    // Iterate over all possible moves
-    for (int i = LBOUND_P1; i <= HBOUND_P1; i++) {
-        // Filter invalid moves
-        if (board->cells[i] == 0) continue;
-        can_move = true;
+// Cells of the 12 pits in index order, the first pit is the most significant
+static const uint8_t egdbPitCells[12] = {0, 1, 2, 3, 4, 5, 7, 8, 9, 10, 11, 12};
 
-        // Make copied board with move made
-        Board next = *board;
-        if (loaded_egdb_is_avalanche) {
-            makeMoveOnBoardAvalanche(&next, i);
-        } else {
-            makeMoveOnBoardClassic(&next, i);
+/**
+ * Steps a board of unhashToBoard to the board of the next index without unranking it.
+ * Indices order the pits lexicographically, so the last non-empty pit hands one stone to the pit
+ * before it and the rest of its stones to the last pit. Returns false after the last board.
+ */
+static inline bool nextEGDBBoard(Board *board) {
+    uint8_t *cells = board->cells;
+
+    int j = 11;
+    while (j > 0 && cells[egdbPitCells[j]] == 0)
+        j--;
+    if (j == 0) return false;
+
+    uint8_t moved = cells[egdbPitCells[j]];
+    cells[egdbPitCells[j]] = 0;
+    cells[egdbPitCells[j - 1]]++;
+    cells[egdbPitCells[11]] = moved - 1;
+    return true;
+}
+
+/**
+ * Layers are solved without recursion. A move that keeps the stone count never ends in a store,
+ * so it never grants an extra turn and leaves every stone on the side of the mover, only further
+ * along. The position weighted stone count of both sides therefore grows with every such move:
+ * the positions of a layer form a DAG whose paths are at most 5 * stones + 1 long. Positions are
+ * visited in index order and a successor that is still open is pushed on a small per thread
+ * stack and solved first, so every position is exact after a single pass and the stack never
+ * holds more frames than the longest path.
+ *
+ * Moves into lower layers land on scattered indices. Each chunk therefore first plays all moves
+ * of its open positions, sorts the lower layer indices and reads them in one ascending pass per
+ * layer, then solves the chunk with only the same layer moves left to play.
+ */
+typedef struct {
+    Board board;
+    uint64_t index;
+    int nextMove;
+    int best;
+    bool canMove;
+
+    // Pits still to play, the gather pass leaves only the same layer moves of chunk positions
+    uint8_t moves;
+
+    // Move waiting for a successor on the frame above, finished without replaying it
+    bool pending;
+    bool pendingSameColor;
+    int pendingDiff;
+    uint64_t pendingIndex;
+} SolveFrame;
+
+// Move into a lower layer, resolved once the values of the whole chunk are gathered
+typedef struct {
+    uint64_t index;
+    uint16_t position;
+    uint8_t layer;
+    bool sameColor;
+    int16_t diff;
+} LowerProbe;
+
+#define EGDB_ALL_MOVES 0x3F
+
+typedef struct {
+    uint64_t start;
+    uint64_t end;
+
+    // Per chunk position: best result of terminal and lower layer moves, and the pits left
+    int16_t best[EGDB_CHUNK_SIZE];
+    bool canMove[EGDB_CHUNK_SIZE];
+    uint8_t moves[EGDB_CHUNK_SIZE];
+
+    LowerProbe *probes;
+    LowerProbe *scratch;
+    uint64_t *indices;
+    int8_t *values;
+    int probeCount;
+} ChunkBatch;
+
+static inline int solveStackDepth(int stones) {
+    return 5 * stones + 2;
+}
+
+// Plays a pit and returns the score difference it gained for player 1
+static inline int playEGDBMove(const Board *board, int pit, Board *next, int *nextStones) {
+    *next = *board;
+    if (loaded_egdb_is_avalanche) {
+        makeMoveOnBoardAvalanche(next, pit);
+    } else {
+        makeMoveOnBoardClassic(next, pit);
+    }
+    processBoardTerminal(next);
+
+    // Count stones remaining after move
+    int stonesLeft = 0;
+    for (int p = LBOUND_P1; p <= HBOUND_P1; p++)
+        stonesLeft += next->cells[p];
+    for (int p = LBOUND_P2; p <= HBOUND_P2; p++)
+        stonesLeft += next->cells[p];
+    *nextStones = stonesLeft;
+
+    return (next->cells[SCORE_P1] - board->cells[SCORE_P1]) - (next->cells[SCORE_P2] - board->cells[SCORE_P2]);
+}
+
+static inline void initFrame(SolveFrame *f, uint64_t index, const ChunkBatch *batch) {
+    f->index = index;
+    f->nextMove = LBOUND_P1;
+    f->best = -127;
+    f->canMove = false;
+    f->moves = EGDB_ALL_MOVES;
+    f->pending = false;
+
+    // Positions of the chunk start with their lower layer moves already resolved
+    if (batch && index >= batch->start && index < batch->end) {
+        uint64_t offset = index - batch->start;
+        f->best = batch->best[offset];
+        f->canMove = batch->canMove[offset];
+        f->moves = batch->moves[offset];
+    }
+}
+
+// Stable LSD radix sort by layer, then index
+static void sortLowerProbes(ChunkBatch *batch) {
+    LowerProbe *src = batch->probes;
+    LowerProbe *dst = batch->scratch;
+    const int count = batch->probeCount;
+
+    uint64_t maxIndex = 0;
+    for (int k = 0; k < count; k++) {
+        if (src[k].index > maxIndex) maxIndex = src[k].index;
+    }
+
+    for (int pass = 0; pass <= 8; pass++) {
+        // Index bytes from low to high, the layer last so it becomes the major key
+        int shift = pass * 8;
+        if (pass < 8 && (maxIndex >> shift) == 0) pass = 8;
+
+        int counts[257] = {0};
+        for (int k = 0; k < count; k++) {
+            int digit = (pass == 8) ? src[k].layer : (int)((src[k].index >> shift) & 0xFF);
+            counts[digit + 1]++;
         }
-        processBoardTerminal(&next);
+        for (int d = 0; d < 256; d++)
+            counts[d + 1] += counts[d];
+        for (int k = 0; k < count; k++) {
+            int digit = (pass == 8) ? src[k].layer : (int)((src[k].index >> shift) & 0xFF);
+            dst[counts[digit]++] = src[k];
+        }
+
+        LowerProbe *swap = src;
+        src = dst;
+        dst = swap;
+    }
 
-        // Count stones remaining after move
-        int next_stones = 0;
-        for (int p = LBOUND_P1; p <= HBOUND_P1; p++)
-            next_stones += next.cells[p];
-        for (int p = LBOUND_P2; p <= HBOUND_P2; p++)
-            next_stones += next.cells[p];
+    batch->probes = src;
+    batch->scratch = dst;
+}
 
-        int diff_gained = (next.cells[SCORE_P1] - board->cells[SCORE_P1]) - (next.cells[SCORE_P2] - board->cells[SCORE_P2]);
+// Plays every move of the open chunk positions and resolves the ones leaving the layer, false if a lower layer read fails
+static bool gatherChunk(int stones, ChunkBatch *batch) {
+    int8_t *table = egdb_tables[stones];
+    batch->probeCount = 0;
 
-        int score = 0;
+    Board board;
+    unhashToBoard(batch->start, stones, &board);
+    for (uint64_t idx = batch->start; idx < batch->end; idx++, nextEGDBBoard(&board)) {
+        const int position = (int)(idx - batch->start);
+        batch->best[position] = -127;
+        batch->canMove[position] = false;
+        batch->moves[position] = 0;
 
-        // Base case: no stones left
-        if (next_stones == 0) {
-            score = diff_gained;
-        } else {
-            int8_t lookup;
-
-            // Probe smaller layer if stones were captured
-            if (next_stones < stones) {
-                // Layer next_stones is guaranteed to be fully computed already
-                lookup = egdb_tables[next_stones][getEGDBIndex(&next, next_stones)];
-            } else if (next.color == board->color) {
-                // Next turn is same player
-                lookup = crunch(next_stones, getEGDBIndex(&next, next_stones), &next);
+        if (__atomic_load_n(&table[idx], __ATOMIC_ACQUIRE) != EGDB_UNCOMPUTED) continue;
+
+        for (int i = LBOUND_P1; i <= HBOUND_P1; i++) {
+            if (board.cells[i] == 0) continue;
+            batch->canMove[position] = true;
+
+            Board next;
+            int next_stones;
+            int diff_gained = playEGDBMove(&board, i, &next, &next_stones);
+
+            if (next_stones == stones) {
+                batch->moves[position] |= (uint8_t)(1 << i);
+            } else if (next_stones == 0) {
+                if (diff_gained > batch->best[position]) batch->best[position] = (int16_t)diff_gained;
             } else {
-                // Next turn is opponent, reorient board
-                Board normalized;
-                unhashToBoard(getEGDBIndex(&next, next_stones), next_stones, &normalized);
-                lookup = crunch(next_stones, getEGDBIndex(&next, next_stones), &normalized);
+                LowerProbe *probe = &batch->probes[batch->probeCount++];
+                probe->index = getEGDBIndex(&next, next_stones);
+                probe->position = (uint16_t)position;
+                probe->layer = (uint8_t)next_stones;
+                probe->sameColor = (next.color == board.color);
+                probe->diff = (int16_t)diff_gained;
             }
+        }
+    }
+
+    sortLowerProbes(batch);
 
-            // Adjust score based on who is playing next
-            score = (next.color == board->color)
-                        ? (diff_gained + lookup)
-                        : (diff_gained - lookup);
+    // One ascending read per lower layer
+    for (int k = 0; k < batch->probeCount;) {
+        const int layer = batch->probes[k].layer;
+        int run = 0;
+        while (k + run < batch->probeCount && batch->probes[k + run].layer == layer) {
+            batch->indices[run] = batch->probes[k + run].index;
+            run++;
         }
 
-        if (score > best_score) best_score = score;
+        if (!egdb_mem_probe_batch(layer, batch->indices, batch->values, run)) return false;
+
+        for (int r = 0; r < run; r++) {
+            const LowerProbe *probe = &batch->probes[k + r];
+            int lookup = batch->values[r];
+            int score = probe->sameColor ? (probe->diff + lookup) : (probe->diff - lookup);
+            if (score > batch->best[probe->position]) batch->best[probe->position] = (int16_t)score;
+        }
+        k += run;
+    }
+
+    return true;
+}
+
+// False if the stack fills, which the DAG bound rules out unless the move rules break it, or a lower layer read fails
+static bool solvePosition(int stones, uint64_t index, const Board *board, SolveFrame *stack, const ChunkBatch *batch, uint64_t *solved) {
+    int8_t *table = egdb_tables[stones];
+    const int maxDepth = solveStackDepth(stones);
+    int top = 0;
+
+    stack[0].board = *board;
+    initFrame(&stack[0], index, batch);
+
+    while (top >= 0) {
+        SolveFrame *f = &stack[top];
+        bool descended = false;
+
+        // The successor of the interrupted move is solved now
+        if (f->pending) {
+            int8_t lookup = __atomic_load_n(&table[f->pendingIndex], __ATOMIC_ACQUIRE);
+            int score = f->pendingSameColor ? (f->pendingDiff + lookup) : (f->pendingDiff - lookup);
+            if (score > f->best) f->best = score;
+            f->pending = false;
+            f->nextMove++;
+        }
+
+        // Iterate over the remaining moves
+        for (; f->nextMove <= HBOUND_P1; f->nextMove++) {
+            int i = f->nextMove;
+
+            // Filter invalid moves and the ones the gather pass resolved
+            if (!(f->moves & (1 << i)) || f->board.cells[i] == 0) continue;
+            f->canMove = true;
+
+            // Make copied board with move made
+            Board next;
+            int next_stones;
+            int diff_gained = playEGDBMove(&f->board, i, &next, &next_stones);
+
+            int score = 0;
+
+            // Base case: no stones left
+            if (next_stones == 0) {
+                score = diff_gained;
+            } else {
+                int8_t lookup = 0;
+
+                if (next_stones < stones) {
+                    // Layer next_stones is guaranteed to be fully computed already, but may be compressed
+                    if (!egdb_mem_probe(next_stones, getEGDBIndex(&next, next_stones), &lookup)) return false;
+                } else {
+                    // Same layer, the index normalizes the side to move
+                    uint64_t nextIndex = getEGDBIndex(&next, next_stones);
+                    lookup = __atomic_load_n(&table[nextIndex], __ATOMIC_ACQUIRE);
+
+                    // Solve the successor first and finish this move afterwards
+                    if (lookup == EGDB_UNCOMPUTED) {
+                        if (top + 1 >= maxDepth) return false;
+
+                        f->pending = true;
+                        f->pendingSameColor = (next.color == f->board.color);
+                        f->pendingDiff = diff_gained;
+                        f->pendingIndex = nextIndex;
+
+                        SolveFrame *child = &stack[++top];
+                        normalizeEGDBBoard(&next, &child->board);
+                        initFrame(child, nextIndex, batch);
+                        descended = true;
+                        break;
+                    }
+                }
+
+                // Adjust score based on who is playing next
+                score = (next.color == f->board.color)
+                            ? (diff_gained + lookup)
+                            : (diff_gained - lookup);
+            }
+
+            if (score > f->best) f->best = score;
+        }
+
+        if (descended) continue;
+
+        // Other threads may solve the same position, they store the same value
+        __atomic_store_n(&table[f->index], (int8_t)(f->canMove ? f->best : 0), __ATOMIC_RELEASE);
+        (*solved)++;
+        top--;
+    }
+
+    return true;
+}
+
+typedef struct {
+    int stones;
+    uint64_t size;
+    uint64_t nextChunk;
+    uint64_t solved;
+
+    // Chunk each thread works on or finished last, every chunk below the minimum is done
+    bool isAvalanche;
+    uint64_t startChunk;
+    int nextSlot;
+    uint64_t activeChunk[EGDB_MAX_THREADS];
+    double lastCheckpoint;
+
+    // First error of any thread, the others stop at their next chunk and the layer is discarded
+    const char *failure;
+} LayerJob;
+
+#define EGDB_CHECKPOINT_MAGIC 0x4B434745 // "EGCK"
+#define EGDB_CHECKPOINT_VERSION 1
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t stones;
+    uint32_t chunkSize;
+    uint64_t size;
+    uint64_t doneChunks;
+} EGDBCheckpoint;
+
+static void checkpointFileName(char *buffer, size_t size, int s, bool is_avalanche) {
+    snprintf(buffer, size, "EGDB/egdb_%s%d.ckpt", is_avalanche ? "av_" : "", s);
+}
+
+/**
+ * Every value in a layer is final once written, so any mix of old and new bytes in the table
+ * file is a valid partial layer. The record only adds how many leading chunks are done, so a
+ * resume can skip them, and is written after the table and renamed into place.
+ */
+static void writeCheckpoint(LayerJob *job) {
+    const uint64_t chunks = (job->size + EGDB_CHUNK_SIZE - 1) / EGDB_CHUNK_SIZE;
+
+    uint64_t done = __atomic_load_n(&job->nextChunk, __ATOMIC_SEQ_CST);
+    for (int t = 0; t < EGDB_MAX_THREADS; t++) {
+        uint64_t active = __atomic_load_n(&job->activeChunk[t], __ATOMIC_SEQ_CST);
+        if (active < done) done = active;
+    }
+    if (done > chunks) done = chunks;
+
+    job->lastCheckpoint = getWallTime();
+    if (!egdb_mem_checkpoint(job->stones, job->size, job->isAvalanche)) return;
+
+    char path[256];
+    checkpointFileName(path, sizeof(path), job->stones, job->isAvalanche);
+
+    EGDBCheckpoint record = {EGDB_CHECKPOINT_MAGIC, EGDB_CHECKPOINT_VERSION, (uint32_t)job->stones, EGDB_CHUNK_SIZE, job->size, done};
+    egdbWriteFile(path, &record, sizeof(record));
+}
+
+// Leading chunks of the layer that a previous run finished, false without a matching record
+static bool readCheckpoint(int s, uint64_t size, bool is_avalanche, uint64_t *doneChunks) {
+    char path[256];
+    checkpointFileName(path, sizeof(path), s, is_avalanche);
+
+    FILE *f = fopen(path, "rb");
+    if (!f) return false;
+
+    EGDBCheckpoint record;
+    bool ok = fread(&record, sizeof(record), 1, f) == 1 &&
+              record.magic == EGDB_CHECKPOINT_MAGIC && record.version == EGDB_CHECKPOINT_VERSION &&
+              record.stones == (uint32_t)s && record.chunkSize == EGDB_CHUNK_SIZE && record.size == size;
+    fclose(f);
+
+    if (ok) *doneChunks = record.doneChunks;
+    return ok;
+}
+
+static void removeCheckpoint(int s, bool is_avalanche) {
+    char path[256];
+    checkpointFileName(path, sizeof(path), s, is_avalanche);
+    remove(path);
+
+    // Left behind by backends that keep the layer in memory
+    snprintf(path, sizeof(path), "EGDB/egdb_%s%d.bin.tmp", is_avalanche ? "av_" : "", s);
+    remove(path);
+}
+
+static void freeChunkBatch(ChunkBatch *batch) {
+    if (!batch) return;
+    free(batch->probes);
+    free(batch->scratch);
+    free(batch->indices);
+    free(batch->values);
+    free(batch);
+}
+
+static ChunkBatch *allocChunkBatch() {
+    const size_t maxProbes = (size_t)EGDB_CHUNK_SIZE * (HBOUND_P1 - LBOUND_P1 + 1);
+
+    ChunkBatch *batch = calloc(1, sizeof(ChunkBatch));
+    if (!batch) return NULL;
+
+    batch->probes = malloc(sizeof(LowerProbe) * maxProbes);
+    batch->scratch = malloc(sizeof(LowerProbe) * maxProbes);
+    batch->indices = malloc(sizeof(uint64_t) * maxProbes);
+    batch->values = malloc(sizeof(int8_t) * maxProbes);
+    if (!batch->probes || !batch->scratch || !batch->indices || !batch->values) {
+        freeChunkBatch(batch);
+        return NULL;
+    }
+
+    return batch;
+}
+
+static void failLayerJob(LayerJob *job, const char *failure) {
+    const char *none = NULL;
+    __atomic_compare_exchange_n(&job->failure, &none, failure, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+static void solveChunks(LayerJob *job, bool reportProgress) {
+    const uint64_t chunks = (job->size + EGDB_CHUNK_SIZE - 1) / EGDB_CHUNK_SIZE;
+    int8_t *table = egdb_tables[job->stones];
+
+    // Published before the first claim, so a checkpoint never counts a claimed chunk as done
+    const int slot = __atomic_fetch_add(&job->nextSlot, 1, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&job->activeChunk[slot], job->startChunk, __ATOMIC_SEQ_CST);
+
+    SolveFrame *stack = malloc(sizeof(SolveFrame) * solveStackDepth(job->stones));
+    ChunkBatch *batch = allocChunkBatch();
+    if (!stack || !batch) {
+        failLayerJob(job, "OOM: no memory for the solve buffers");
+        free(stack);
+        freeChunkBatch(batch);
+        return;
+    }
+
+    while (__atomic_load_n(&job->failure, __ATOMIC_SEQ_CST) == NULL) {
+        uint64_t chunk = __atomic_fetch_add(&job->nextChunk, 1, __ATOMIC_SEQ_CST);
+        if (chunk >= chunks) break;
+        __atomic_store_n(&job->activeChunk[slot], chunk, __ATOMIC_SEQ_CST);
+
+        batch->start = chunk * EGDB_CHUNK_SIZE;
+        batch->end = min(batch->start + EGDB_CHUNK_SIZE, job->size);
+        uint64_t solved = 0;
+
+        if (!gatherChunk(job->stones, batch)) {
+            failLayerJob(job, "reading a lower layer failed");
+            break;
+        }
+
+        // Only the first board of a chunk is unranked, the others follow in index order
+        // Ascending indices also keep most same layer lookups close together
+        Board board;
+        unhashToBoard(batch->start, job->stones, &board);
+        for (uint64_t idx = batch->start; idx < batch->end; idx++, nextEGDBBoard(&board)) {
+            if (__atomic_load_n(&table[idx], __ATOMIC_ACQUIRE) != EGDB_UNCOMPUTED) continue;
+            if (!solvePosition(job->stones, idx, &board, stack, batch, &solved)) {
+                failLayerJob(job, "solve stack full or a lower layer read failed");
+                break;
+            }
+        }
+
+        uint64_t total = __atomic_add_fetch(&job->solved, solved, __ATOMIC_RELAXED);
+        if (reportProgress) updateEGDBProgress(job->stones, total, job->size);
+
+        // The progress thread also writes the checkpoints, the others keep solving meanwhile
+        if (reportProgress && egdb_checkpoint_interval > 0 &&
+            getWallTime() - job->lastCheckpoint >= egdb_checkpoint_interval) {
+            writeCheckpoint(job);
+        }
+    }
+
+    __atomic_store_n(&job->activeChunk[slot], chunks, __ATOMIC_SEQ_CST);
+    free(stack);
+    freeChunkBatch(batch);
+}
+
+#ifndef WEB_BUILD
+static void *solveWorker(void *arg) {
+    solveChunks((LayerJob *)arg, false);
+    return NULL;
+}
+#endif
+
+// Solves every open position of the layer, false with the reason if a thread failed
+static bool generateLayer(int s, uint64_t size, bool is_avalanche, uint64_t startChunk, const char **failure) {
+    LayerJob job = {.stones = s, .size = size, .nextChunk = startChunk, .solved = min(startChunk * EGDB_CHUNK_SIZE, size)};
+    job.isAvalanche = is_avalanche;
+    job.startChunk = startChunk;
+    job.lastCheckpoint = getWallTime();
+    for (int t = 0; t < EGDB_MAX_THREADS; t++) {
+        job.activeChunk[t] = UINT64_MAX;
     }
 
-    if (!can_move) best_score = 0;
+    int threads = egdb_threads > 0 ? egdb_threads : getProcessorCount();
+    uint64_t chunks = (size + EGDB_CHUNK_SIZE - 1) / EGDB_CHUNK_SIZE;
+    if ((uint64_t)threads > chunks) threads = (int)chunks;
+    if (threads < 1) threads = 1;
 
-    egdb_tables[stones][index] = best_score;
-    return best_score;
+    startEGDBProgress();
+    double start = getWallTime();
+
+#ifndef WEB_BUILD
+    // The calling thread works too and is the only one drawing progress
+    pthread_t workers[EGDB_MAX_THREADS];
+    int started = 0;
+    for (int t = 1; t < threads && t < EGDB_MAX_THREADS; t++) {
+        if (pthread_create(&workers[started], NULL, solveWorker, &job) == 0) started++;
+    }
+    solveChunks(&job, true);
+    for (int t = 0; t < started; t++) {
+        pthread_join(workers[t], NULL);
+    }
+    threads = started + 1;
+#else
+    threads = 1;
+    solveChunks(&job, true);
+#endif
+
+    double elapsed = getWallTime() - start;
+    *failure = job.failure;
+    if (job.failure) {
+        finishEGDBProgress();
+        return false;
+    }
+    updateEGDBProgress(s, size, size);
+    finishEGDBProgress();
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "Layer %d: %" PRIu64 " positions in %.2fs (%.2f M pos/s, %d threads)",
+             s, size, elapsed, elapsed > 0 ? (double)size / elapsed / 1e6 : 0.0, threads);
+    renderOutput(msg, CONFIG_PREFIX);
+    return true;
 }
 
 void generateEGDB(int max_stones, bool is_avalanche) {
@@ -230,60 +811,499 @@ void generateEGDB(int max_stones, bool is_avalanche) {
     snprintf(msg, sizeof(msg), "Checking EGDB %s(1..%d) [%s]...", is_avalanche ? "Avalanche " : "", max_stones, EGDB_BACKEND_NAME);
     renderOutput(msg, CONFIG_PREFIX);
 
+    // Layers of a packed container need neither a file of their own nor a backend
+    char path[256];
+    char reason[128];
+    egdbContainerPath(path, sizeof(path), is_avalanche);
+    int packed = egdbContainerOpen(is_avalanche, reason, sizeof(reason));
+    if (packed < 0) {
+        snprintf(msg, sizeof(msg), "Ignoring %s: %s", path, reason);
+        renderOutput(msg, CONFIG_PREFIX);
+    } else if (packed > 0) {
+        snprintf(msg, sizeof(msg), "Mapped layers 1..%d from %s", min(packed, max_stones), path);
+        renderOutput(msg, CONFIG_PREFIX);
+    }
+
     // Build layers iteratively
     for (int s = 1; s <= max_stones; s++) {
         uint64_t size = ways[s][12];
 
+        uint64_t packedSize = 0;
+        int8_t *packedLayer = egdbContainerLayer(s, &packedSize);
+        if (packedLayer && packedSize == size) {
+            egdb_tables[s] = packedLayer;
+            loaded_egdb_max_stones = s;
+            continue;
+        }
+
         // If not found on disk, we must compute it
         if (!egdb_mem_load(s, size, is_avalanche)) {
             snprintf(msg, sizeof(msg), "Generating layer %d...", s);
             renderOutput(msg, CONFIG_PREFIX);
 
-            egdb_mem_alloc(s, size);
-            if (!egdb_tables[s]) {
-                renderOutput("OOM", CONFIG_PREFIX);
+            uint64_t doneChunks = 0;
+            if (readCheckpoint(s, size, is_avalanche, &doneChunks) && egdb_mem_resume(s, size, is_avalanche)) {
+                snprintf(msg, sizeof(msg), "Resuming layer %d from checkpoint (%.1f%%)...",
+                         s, 100.0 * (double)min(doneChunks * EGDB_CHUNK_SIZE, size) / (double)size);
+                renderOutput(msg, CONFIG_PREFIX);
+            } else {
+                doneChunks = 0;
+                egdb_mem_alloc(s, size, is_avalanche);
+                if (!egdb_tables[s]) {
+                    snprintf(msg, sizeof(msg), "OOM: layer %d needs %.2f GB", s, (double)size / 1073741824.0);
+                    renderOutput(msg, CONFIG_PREFIX);
+                    break;
+                }
+                memset(egdb_tables[s], EGDB_UNCOMPUTED, size);
+            }
+
+            // A failed layer is never saved, its open positions would read as EGDB_UNCOMPUTED
+            const char *failure = NULL;
+            if (!generateLayer(s, size, is_avalanche, doneChunks, &failure)) {
+                snprintf(msg, sizeof(msg), "Layer %d failed: %s", s, failure);
+                renderOutput(msg, CONFIG_PREFIX);
+                egdb_mem_free_layer(s, size);
+                egdb_tables[s] = NULL;
                 break;
             }
-            memset(egdb_tables[s], EGDB_UNCOMPUTED, size);
 
-            startEGDBProgress();
-            uint64_t interval = size / 200;
-            if (!interval) interval = 1;
+            if (!egdb_mem_save(s, size, is_avalanche)) {
+                snprintf(msg, sizeof(msg), "Saving layer %d failed", s);
+                renderOutput(msg, CONFIG_PREFIX);
+                egdb_mem_free_layer(s, size);
+                egdb_tables[s] = NULL;
+                break;
+            }
+            removeCheckpoint(s, is_avalanche);
+        }
+
+        loaded_egdb_max_stones = s;
+    }
+}
 
-            // Crunch all states in current layer
-            for (uint64_t idx = 0; idx < size; idx++) {
-                if (idx % interval == 0) updateEGDBProgress(s, idx, size);
+void verifyEGDB() {
+    char msg[320];
+    char path[256];
+    char reason[128];
+    egdbContainerPath(path, sizeof(path), loaded_egdb_is_avalanche);
 
-                if (egdb_tables[s][idx] == EGDB_UNCOMPUTED) {
-                    Board b;
-                    unhashToBoard(idx, s, &b);
-                    crunch(s, idx, &b);
-                }
-            }
+    uint64_t positions = 0;
+    if (loaded_egdb_max_stones <= 0 || !egdbContainerLayer(1, &positions)) {
+        renderOutput("No EGDB container mapped, use egdb pack and egdb N first", CONFIG_PREFIX);
+        return;
+    }
+
+    double start = getWallTime();
+    uint64_t blocks = 0;
+    if (egdbContainerVerify(&blocks, reason, sizeof(reason))) {
+        snprintf(msg, sizeof(msg), "Verified %s: %" PRIu64 " blocks in %.2fs", path, blocks, getWallTime() - start);
+        renderOutput(msg, CONFIG_PREFIX);
+        return;
+    }
+
+    snprintf(msg, sizeof(msg), "Damaged %s: %s, freed the EGDB", path, reason);
+    renderOutput(msg, CONFIG_PREFIX);
+    freeEGDB();
+}
 
-            updateEGDBProgress(s, size, size);
-            finishEGDBProgress();
+void removeEGDBFiles(int max_stones, bool is_avalanche) {
+    char path[256];
+    egdbContainerPath(path, sizeof(path), is_avalanche);
+    remove(path);
 
-            egdb_mem_save(s, size, is_avalanche);
+    for (int s = 1; s <= max_stones && s <= EGDB_MAX_STONES; s++) {
+        snprintf(path, sizeof(path), "EGDB/egdb_%s%d.bin", is_avalanche ? "av_" : "", s);
+        remove(path);
+        egdb_mem_remove(s, is_avalanche);
+        removeCheckpoint(s, is_avalanche);
+    }
+}
+
+// Plain tables are copied, compressed ones are decoded through ascending batch probes
+static bool readLayerValues(int s, uint64_t start, int8_t *buffer, uint64_t count) {
+    if (egdb_tables[s]) {
+        memcpy(buffer, egdb_tables[s] + start, count);
+        return true;
+    }
+
+    uint64_t indices[1024];
+    for (uint64_t done = 0; done < count;) {
+        int n = (int)min(count - done, (uint64_t)1024);
+        for (int k = 0; k < n; k++) {
+            indices[k] = start + done + (uint64_t)k;
         }
+        if (!egdb_mem_probe_batch(s, indices, buffer + done, n)) return false;
+        done += (uint64_t)n;
+    }
+    return true;
+}
 
-        loaded_egdb_max_stones = s;
+void packEGDB() {
+    char msg[320];
+    char path[256];
+
+    if (loaded_egdb_max_stones <= 0) {
+        renderOutput("No EGDB loaded, use egdb N first", CONFIG_PREFIX);
+        return;
+    }
+
+    uint64_t sizes[EGDB_MAX_STONES + 1] = {0};
+    for (int s = 1; s <= loaded_egdb_max_stones; s++) {
+        sizes[s] = ways[s][12];
+    }
+
+    egdbContainerPath(path, sizeof(path), loaded_egdb_is_avalanche);
+    double start = getWallTime();
+
+    if (egdbContainerWrite(loaded_egdb_max_stones, loaded_egdb_is_avalanche, sizes, readLayerValues)) {
+        snprintf(msg, sizeof(msg), "Packed layers 1..%d into %s in %.2fs", loaded_egdb_max_stones, path, getWallTime() - start);
+    } else {
+        snprintf(msg, sizeof(msg), "Failed to write %s", path);
+    }
+    renderOutput(msg, CONFIG_PREFIX);
+}
+
+#define EGDB_WDL_MAGIC 0x314C4457 // "WDL1"
+#define EGDB_WDL_READ_CHUNK (1 << 20)
+
+typedef struct {
+    uint32_t magic;
+    uint32_t stones;
+    uint64_t positions;
+} EGDBWDLHeader;
+
+static inline uint64_t wdlBytes(int s) {
+    return (ways[s][12] + 3) / 4;
+}
+
+static void wdlFileName(char *buffer, size_t size, int s, bool is_avalanche) {
+    snprintf(buffer, size, "EGDB/egdb_%s%d.wdl", is_avalanche ? "av_" : "", s);
+}
+
+static bool readWDLLayer(int s, bool is_avalanche) {
+    char filename[256];
+    wdlFileName(filename, sizeof(filename), s, is_avalanche);
+
+    FILE *f = fopen(filename, "rb");
+    if (!f) return false;
+
+    EGDBWDLHeader header;
+    const uint64_t bytes = wdlBytes(s);
+    bool ok = fread(&header, sizeof(header), 1, f) == 1 && header.magic == EGDB_WDL_MAGIC &&
+              header.stones == (uint32_t)s && header.positions == ways[s][12];
+
+    uint8_t *table = ok ? malloc(bytes) : NULL;
+    ok = table && fread(table, 1, bytes, f) == bytes && fgetc(f) == EOF;
+    fclose(f);
+
+    if (!ok) {
+        free(table);
+        return false;
+    }
+    wdl_tables[s] = table;
+    return true;
+}
+
+// Reduces the exact layer to signs, from the loaded table if there is one or else from its .bin
+static bool buildWDLLayer(int s, bool is_avalanche) {
+    const uint64_t size = ways[s][12];
+    const bool fromTables = s <= loaded_egdb_max_stones && loaded_egdb_is_avalanche == is_avalanche;
+
+    FILE *bin = NULL;
+    if (!fromTables) {
+        char bin_filename[256];
+        snprintf(bin_filename, sizeof(bin_filename), "EGDB/egdb_%s%d.bin", is_avalanche ? "av_" : "", s);
+        bin = fopen(bin_filename, "rb");
+        if (!bin) return false;
+    }
+
+    uint8_t *table = calloc(wdlBytes(s), 1);
+    int8_t *values = malloc(EGDB_WDL_READ_CHUNK);
+    bool ok = table && values;
+
+    // Chunks are a multiple of 4, so every chunk starts on a byte of the table
+    for (uint64_t start = 0; ok && start < size; start += EGDB_WDL_READ_CHUNK) {
+        uint64_t count = min(size - start, (uint64_t)EGDB_WDL_READ_CHUNK);
+        ok = fromTables ? readLayerValues(s, start, values, count) : fread(values, 1, count, bin) == count;
+
+        for (uint64_t k = 0; ok && k < count; k++) {
+            int v = values[k];
+            uint8_t code = (v == EGDB_UNCOMPUTED) ? EGDB_WDL_UNKNOWN : (v > 0) ? EGDB_WDL_WIN : (v == 0) ? EGDB_WDL_DRAW : EGDB_WDL_LOSS;
+            uint64_t idx = start + k;
+            table[idx >> 2] |= (uint8_t)(code << ((idx & 3) * 2));
+        }
+    }
+
+    free(values);
+    if (bin) fclose(bin);
+    if (!ok) {
+        free(table);
+        return false;
     }
+    wdl_tables[s] = table;
+    return true;
+}
+
+static bool writeWDLContents(FILE *f, void *context) {
+    const int s = *(const int *)context;
+    EGDBWDLHeader header = {EGDB_WDL_MAGIC, (uint32_t)s, ways[s][12]};
+    return fwrite(&header, sizeof(header), 1, f) == 1 && fwrite(wdl_tables[s], 1, wdlBytes(s), f) == wdlBytes(s);
+}
+
+// Written next to the old file and renamed, like the checkpoints
+static bool writeWDLLayer(int s, bool is_avalanche) {
+    char filename[256];
+    wdlFileName(filename, sizeof(filename), s, is_avalanche);
+    return writeFileReplacing(filename, writeWDLContents, &s);
+}
+
+void loadEGDBWDL(int max_stones, bool is_avalanche) {
+    char msg[320];
+    initWaysTable();
+    freeEGDBWDL();
+    if (max_stones <= 0) return;
+
+    MKDIR("EGDB");
+    loaded_wdl_is_avalanche = is_avalanche;
+    double start = getWallTime();
+    int built = 0;
+
+    for (int s = 1; s <= max_stones; s++) {
+        if (!readWDLLayer(s, is_avalanche)) {
+            if (!buildWDLLayer(s, is_avalanche)) {
+                snprintf(msg, sizeof(msg), "WDL layer %d needs its exact layer, run egdb %d%s first",
+                         s, s, is_avalanche ? " --avalanche" : "");
+                renderOutput(msg, CONFIG_PREFIX);
+                break;
+            }
+            if (!writeWDLLayer(s, is_avalanche)) {
+                snprintf(msg, sizeof(msg), "Could not save WDL layer %d, keeping it in memory only", s);
+                renderOutput(msg, CONFIG_PREFIX);
+            }
+            built++;
+        }
+        loaded_wdl_max_stones = s;
+    }
+
+    if (loaded_wdl_max_stones > 0) {
+        uint64_t sizeBytes, hits;
+        int maxStones;
+        getEGDBWDLStats(&sizeBytes, &hits, &maxStones);
+        snprintf(msg, sizeof(msg), "WDL %s1..%d: %.2f MB, %d layers derived in %.2fs", is_avalanche ? "Avalanche " : "",
+                 loaded_wdl_max_stones, (double)sizeBytes / 1048576.0, built, getWallTime() - start);
+        renderOutput(msg, CONFIG_PREFIX);
+    }
+}
+
+void freeEGDBWDL() {
+    for (int s = 1; s <= loaded_wdl_max_stones; s++) {
+        free(wdl_tables[s]);
+        wdl_tables[s] = NULL;
+    }
+    loaded_wdl_max_stones = 0;
+    loaded_wdl_is_avalanche = false;
+    wdl_hits = 0;
+}
+
+bool EGDB_probe_wdl(Board *board, int *wdl) {
+    if ((getMoveFunction() != CLASSIC_MOVE) != loaded_wdl_is_avalanche) return false;
+
+    int stonesLeft = egdb_total_stones_configured - board->cells[SCORE_P1] - board->cells[SCORE_P2];
+    if (stonesLeft <= 0 || stonesLeft > loaded_wdl_max_stones) return false;
+
+    uint64_t idx = getEGDBIndex(board, stonesLeft);
+    int code = (wdl_tables[stonesLeft][idx >> 2] >> ((idx & 3) * 2)) & 3;
+    if (code == EGDB_WDL_UNKNOWN) return false;
+
+    *wdl = code - EGDB_WDL_DRAW;
+    wdl_hits++;
+    return true;
+}
+
+void getEGDBWDLStats(uint64_t *sizeBytes, uint64_t *hits, int *maxStones) {
+    *hits = wdl_hits;
+    *maxStones = loaded_wdl_max_stones;
+    *sizeBytes = 0;
+    for (int s = 1; s <= loaded_wdl_max_stones; s++) {
+        *sizeBytes += wdlBytes(s);
+    }
+}
+
+void trimEGDBWDL(int max_stones) {
+    if (max_stones <= 0) {
+        freeEGDBWDL();
+        return;
+    }
+
+    for (int s = max_stones + 1; s <= loaded_wdl_max_stones; s++) {
+        free(wdl_tables[s]);
+        wdl_tables[s] = NULL;
+    }
+
+    if (loaded_wdl_max_stones > max_stones) loaded_wdl_max_stones = max_stones;
+}
+
+int planEGDBWDLLayers(uint64_t budgetBytes) {
+    initWaysTable();
+    int limit = min(egdb_total_stones_configured, EGDB_MAX_STONES);
+
+    int layers = 0;
+    uint64_t total = 0;
+    while (layers < limit && total + wdlBytes(layers + 1) <= budgetBytes) {
+        layers++;
+        total += wdlBytes(layers);
+    }
+    return layers;
 }
 
 void freeEGDB() {
     for (int s = 1; s <= loaded_egdb_max_stones; s++) {
-        if (egdb_tables[s] || egdb_mem_get_size(s, ways[s][12]) > 0) {
+        if (egdbContainerOwns(egdb_tables[s])) {
+            egdb_tables[s] = NULL;
+        } else if (egdb_tables[s] || egdb_mem_get_size(s, ways[s][12]) > 0) {
             egdb_mem_free_layer(s, ways[s][12]);
             egdb_tables[s] = NULL;
         }
     }
+    egdbContainerClose();
 
     loaded_egdb_max_stones = 0;
     loaded_egdb_is_avalanche = false;
     resetEGDBStats();
 }
 
+void trimEGDB(int max_stones) {
+    if (max_stones <= 0) {
+        freeEGDB();
+        return;
+    }
+
+    for (int s = max_stones + 1; s <= loaded_egdb_max_stones; s++) {
+        if (!egdbContainerOwns(egdb_tables[s])) egdb_mem_free_layer(s, ways[s][12]);
+        egdb_tables[s] = NULL;
+    }
+
+    if (loaded_egdb_max_stones > max_stones) loaded_egdb_max_stones = max_stones;
+}
+
+uint64_t estimateEGDBSize(int max_stones) {
+    initWaysTable();
+
+    // Layers that are not loaded are assumed to compress like the loaded ones
+    uint64_t measured = 0;
+    uint64_t measuredRaw = 0;
+    for (int s = 1; s <= loaded_egdb_max_stones; s++) {
+        measured += egdb_mem_get_size(s, ways[s][12]);
+        measuredRaw += ways[s][12];
+    }
+    double ratio = (measured > 0 && measuredRaw > 0) ? (double)measured / (double)measuredRaw : 1.0;
+
+    uint64_t total = 0;
+    for (int s = 1; s <= max_stones && s <= EGDB_MAX_STONES; s++) {
+        if (s <= loaded_egdb_max_stones) {
+            total += egdb_mem_get_size(s, ways[s][12]);
+        } else {
+            total += (uint64_t)((double)ways[s][12] * ratio);
+        }
+    }
+    return total;
+}
+
+int planEGDBLayers(uint64_t budgetBytes) {
+    // Layers above the stones of the game are never probed
+    int limit = min(egdb_total_stones_configured, EGDB_MAX_STONES);
+
+    int layers = 0;
+    while (layers < limit && estimateEGDBSize(layers + 1) <= budgetBytes) {
+        layers++;
+    }
+    return layers;
+}
+
+void benchmarkEGDBIndex(int stones, uint64_t samples) {
+    initWaysTable();
+    if (stones < 1 || stones > EGDB_MAX_STONES) return;
+
+    const uint64_t size = ways[stones][12];
+    const int batch = 4096;
+    uint64_t *indices = malloc(sizeof(uint64_t) * batch);
+    Board *boards = malloc(sizeof(Board) * batch);
+    if (!indices || !boards) {
+        free(indices);
+        free(boards);
+        return;
+    }
+
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    uint64_t checksum = 0;
+    uint64_t mismatches = 0;
+    uint64_t done = 0;
+    double unrankTime = 0;
+    double rankTime = 0;
+
+    printf("EGDB index: %d stones, %" PRIu64 " boards, %" PRIu64 " samples\n", stones, size, samples);
+
+    // Random indices, the probe pattern of the solver
+    while (done < samples) {
+        for (int i = 0; i < batch; i++) {
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            indices[i] = seed % size;
+        }
+
+        double start = getWallTime();
+        for (int i = 0; i < batch; i++) {
+            unhashToBoard(indices[i], stones, &boards[i]);
+        }
+        unrankTime += getWallTime() - start;
+
+        start = getWallTime();
+        for (int i = 0; i < batch; i++) {
+            uint64_t back = getEGDBIndex(&boards[i], stones);
+            mismatches += (back != indices[i]);
+            checksum += back;
+        }
+        rankTime += getWallTime() - start;
+
+        done += batch;
+    }
+
+    // Ascending indices, the pattern of the generator
+    Board board;
+    uint64_t count = min(samples, size);
+    double start = getWallTime();
+    for (uint64_t idx = 0; idx < count; idx++) {
+        unhashToBoard(idx, stones, &board);
+        checksum += board.cells[0];
+    }
+    double sequentialTime = getWallTime() - start;
+
+    // Same boards stepped from one index to the next
+    uint64_t stepMismatches = 0;
+    unhashToBoard(0, stones, &board);
+    start = getWallTime();
+    for (uint64_t idx = 0; idx < count; idx++, nextEGDBBoard(&board)) {
+        checksum += board.cells[0];
+    }
+    double stepTime = getWallTime() - start;
+
+    unhashToBoard(0, stones, &board);
+    for (uint64_t idx = 0; idx < min(count, (uint64_t)1000000); idx++, nextEGDBBoard(&board)) {
+        stepMismatches += (getEGDBIndex(&board, stones) != idx);
+    }
+    mismatches += stepMismatches;
+
+    printf("  Unrank (random):     %.1f ns\n", unrankTime * 1e9 / (double)done);
+    printf("  Rank (random):       %.1f ns\n", rankTime * 1e9 / (double)done);
+    printf("  Unrank (sequential): %.1f ns\n", sequentialTime * 1e9 / (double)count);
+    printf("  Step (sequential):   %.1f ns\n", stepTime * 1e9 / (double)count);
+    printf("  Mismatches: %" PRIu64 " (checksum %" PRIu64 ")\n", mismatches, checksum);
+
+    free(indices);
+    free(boards);
+}
+
 void getEGDBStats(uint64_t *sizeBytes, uint64_t *hits, int *minStones, int *maxStones) {
     *hits = egdb_hits;
     *minStones = 1;
@@ -298,4 +1318,23 @@ void getEGDBStats(uint64_t *sizeBytes, uint64_t *hits, int *minStones, int *maxS
 
 void resetEGDBStats() {
     egdb_hits = 0;
+    egdb_bound_hits = 0;
+    wdl_hits = 0;
+    egdb_mem_reset_cache_stats();
+}
+
+uint64_t getEGDBBoundHits() {
+    return egdb_bound_hits;
+}
+
+void getEGDBCacheStats(uint64_t *hits, uint64_t *misses, uint64_t *bytes) {
+    egdb_mem_get_cache_stats(hits, misses, bytes);
+}
+
+bool setEGDBCacheSize(uint64_t bytes) {
+    return egdb_mem_set_cache_size(bytes);
+}
+
+uint64_t getEGDBCacheSize() {
+    return egdb_mem_get_cache_size();
 }
@@ -0,0 +1,406 @@
+/**
+ * Copyright (c) Alexander Kurtz 2026
+ */
+
+#include "logic/solver/egdb/block_cache.h"
+#include "logic/solver/egdb/core.h"
+#include "logic/solver/egdb/common.h"
+#include "logic/solver/egdb/egdb_mem.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/mman.h>
+
+typedef struct {
+    // Odd while a store or an invalidation rewrites the set
+    uint32_t seq;
+    uint8_t used[EGDB_CACHE_WAYS];
+    uint8_t hand;
+    uint64_t key[EGDB_CACHE_WAYS];
+    int8_t data[EGDB_CACHE_WAYS][EGDB_CACHE_BLOCK_SIZE];
+} BlockCacheSet;
+
+typedef struct {
+    pthread_mutex_t lock;
+    BlockCacheSet *sets;
+    uint64_t hits;
+    uint64_t misses;
+} BlockCacheShard;
+
+static BlockCacheShard blockCache[EGDB_CACHE_SHARDS];
+static uint64_t blockCacheSets = 0;
+static uint64_t blockCacheBytes = EGDB_CACHE_DEFAULT_BYTES;
+static bool blockCacheReady = false;
+
+// Set once a backend asked for the cache, later size changes allocate right away
+static bool blockCacheWanted = false;
+
+// 0 marks an empty way
+static inline uint64_t blockKey(int s, uint64_t chunk_id) {
+    return (((uint64_t)s << 48) | chunk_id) + 1;
+}
+
+static inline BlockCacheShard *blockShard(uint64_t key, BlockCacheSet **set) {
+    uint64_t h = key * 0x9E3779B97F4A7C15ULL;
+    BlockCacheShard *shard = &blockCache[(h >> 58) % EGDB_CACHE_SHARDS];
+    *set = &shard->sets[(h >> 20) % blockCacheSets];
+    return shard;
+}
+
+// Readers that started before the matching endWrite see the counter change and retry as a miss
+static inline void beginWrite(BlockCacheSet *set) {
+    __atomic_store_n(&set->seq, set->seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static inline void endWrite(BlockCacheSet *set) {
+    __atomic_store_n(&set->seq, set->seq + 1, __ATOMIC_RELEASE);
+}
+
+static void releaseBlockCache() {
+    if (!blockCacheReady) return;
+
+    for (int i = 0; i < EGDB_CACHE_SHARDS; i++) {
+        free(blockCache[i].sets);
+        blockCache[i].sets = NULL;
+        pthread_mutex_destroy(&blockCache[i].lock);
+    }
+    blockCacheSets = 0;
+    blockCacheReady = false;
+}
+
+void initBlockCache() {
+    blockCacheWanted = true;
+    if (blockCacheReady || blockCacheBytes == 0) return;
+
+    uint64_t sets = blockCacheBytes / EGDB_CACHE_SHARDS / sizeof(BlockCacheSet);
+    if (sets == 0) sets = 1;
+
+    for (int i = 0; i < EGDB_CACHE_SHARDS; i++) {
+        BlockCacheShard *shard = &blockCache[i];
+        shard->sets = calloc(sets, sizeof(BlockCacheSet));
+        if (!shard->sets) {
+            // Without memory for the cache every probe decodes its block
+            for (int j = 0; j < i; j++) {
+                free(blockCache[j].sets);
+                blockCache[j].sets = NULL;
+                pthread_mutex_destroy(&blockCache[j].lock);
+            }
+            return;
+        }
+
+        pthread_mutex_init(&shard->lock, NULL);
+        shard->hits = 0;
+        shard->misses = 0;
+    }
+
+    blockCacheSets = sets;
+    blockCacheReady = true;
+}
+
+bool setBlockCacheBytes(uint64_t bytes) {
+    releaseBlockCache();
+    blockCacheBytes = bytes;
+
+    // A cache that was never used is allocated with the first EGDB
+    if (!blockCacheWanted || bytes == 0) return true;
+    initBlockCache();
+    return blockCacheReady;
+}
+
+uint64_t getBlockCacheBytes() {
+    return blockCacheBytes;
+}
+
+void invalidateBlockCache(int s) {
+    if (!blockCacheReady) return;
+
+    for (int i = 0; i < EGDB_CACHE_SHARDS; i++) {
+        BlockCacheShard *shard = &blockCache[i];
+        pthread_mutex_lock(&shard->lock);
+        for (uint64_t set = 0; set < blockCacheSets; set++) {
+            BlockCacheSet *entry = &shard->sets[set];
+            for (int w = 0; w < EGDB_CACHE_WAYS; w++) {
+                uint64_t key = entry->key[w];
+                if (key == 0 || (int)((key - 1) >> 48) != s) continue;
+
+                beginWrite(entry);
+                __atomic_store_n(&entry->key[w], 0, __ATOMIC_RELAXED);
+                endWrite(entry);
+            }
+        }
+        pthread_mutex_unlock(&shard->lock);
+    }
+}
+
+bool readCachedBlock(int s, uint64_t chunk_id, const uint64_t *offsets, int count, int8_t *vals) {
+    if (!blockCacheReady) return false;
+
+    const uint64_t key = blockKey(s, chunk_id);
+    BlockCacheSet *set;
+    BlockCacheShard *shard = blockShard(key, &set);
+
+    const uint32_t seq = __atomic_load_n(&set->seq, __ATOMIC_ACQUIRE);
+    if ((seq & 1) == 0) {
+        for (int w = 0; w < EGDB_CACHE_WAYS; w++) {
+            if (__atomic_load_n(&set->key[w], __ATOMIC_RELAXED) != key) continue;
+
+            for (int k = 0; k < count; k++) {
+                vals[k] = set->data[w][offsets[k]];
+            }
+
+            // The values only count if no store touched the set while they were copied
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(&set->seq, __ATOMIC_RELAXED) != seq) break;
+
+            if (!__atomic_load_n(&set->used[w], __ATOMIC_RELAXED)) __atomic_store_n(&set->used[w], 1, __ATOMIC_RELAXED);
+            __atomic_fetch_add(&shard->hits, 1, __ATOMIC_RELAXED);
+            return true;
+        }
+    }
+
+    __atomic_fetch_add(&shard->misses, 1, __ATOMIC_RELAXED);
+    return false;
+}
+
+void storeCachedBlock(int s, uint64_t chunk_id, const int8_t *block) {
+    if (!blockCacheReady) return;
+
+    const uint64_t key = blockKey(s, chunk_id);
+    BlockCacheSet *set;
+    BlockCacheShard *shard = blockShard(key, &set);
+
+    pthread_mutex_lock(&shard->lock);
+
+    // Another thread may have decoded the same block meanwhile, otherwise an empty way or the first one not used since the hand passed it
+    int w = -1;
+    for (int r = 0; r < EGDB_CACHE_WAYS && w < 0; r++) {
+        if (set->key[r] == key) w = r;
+    }
+    for (int r = 0; r < EGDB_CACHE_WAYS && w < 0; r++) {
+        if (set->key[r] == 0) w = r;
+    }
+    while (w < 0) {
+        int r = set->hand;
+        set->hand = (uint8_t)((r + 1) % EGDB_CACHE_WAYS);
+        if (__atomic_load_n(&set->used[r], __ATOMIC_RELAXED)) {
+            __atomic_store_n(&set->used[r], 0, __ATOMIC_RELAXED);
+        } else {
+            w = r;
+        }
+    }
+
+    beginWrite(set);
+    __atomic_store_n(&set->key[w], key, __ATOMIC_RELAXED);
+    memcpy(set->data[w], block, EGDB_CACHE_BLOCK_SIZE);
+    __atomic_store_n(&set->used[w], 1, __ATOMIC_RELAXED);
+    endWrite(set);
+
+    pthread_mutex_unlock(&shard->lock);
+}
+
+void releaseBlockLayer(EGDBBlockLayer *layer, int s) {
+    invalidateBlockCache(s);
+
+    if (layer->map) {
+        munmap(layer->map, layer->map_size);
+    } else {
+        free(layer->data);
+        free(layer->offsets);
+        free(layer->bounds);
+        free(layer->dict);
+    }
+    memset(layer, 0, sizeof(*layer));
+}
+
+bool compressBlockLayer(EGDBBlockLayer *layer, const int8_t *raw_data, uint64_t size, uint64_t bound, EGDBBlockEncoder encode, void *context) {
+    const uint64_t chunks = blockLayerChunks(size);
+
+    uint64_t *offsets = malloc((chunks + 1) * sizeof(uint64_t));
+    uint8_t *buffer = malloc(chunks * bound);
+    bool ok = offsets && buffer;
+
+    uint64_t offset = 0;
+    for (uint64_t i = 0; ok && i < chunks; i++) {
+        const uint64_t start = i * EGDB_CACHE_BLOCK_SIZE;
+        const uint64_t written = encode(context, &raw_data[start], min(size - start, (uint64_t)EGDB_CACHE_BLOCK_SIZE), &buffer[offset], bound);
+
+        offsets[i] = offset;
+        offset += written;
+        ok = written > 0;
+    }
+
+    // Copied out at the final size, the buffer was sized for the worst case
+    uint8_t *data = ok ? malloc(offset) : NULL;
+    if (data) memcpy(data, buffer, offset);
+    free(buffer);
+
+    if (!data) {
+        free(offsets);
+        return false;
+    }
+    offsets[chunks] = offset;
+
+    layer->compressed = true;
+    layer->data = data;
+    layer->offsets = offsets;
+    layer->bytes = offset;
+    layer->chunks = chunks;
+
+    // Summaries are optional, a layer without them only answers exact probes
+    layer->bounds = malloc(2 * chunks);
+    if (layer->bounds) summarizeEGDBBlocks(raw_data, size, EGDB_CACHE_BLOCK_SIZE, layer->bounds);
+    return true;
+}
+
+bool attachBlockFile(EGDBBlockLayer *layer, uint8_t *base, uint64_t file_size, uint64_t offsets_start, uint64_t chunks) {
+    const uint64_t data_start = offsets_start + (chunks + 1) * sizeof(uint64_t);
+    if (data_start > file_size) return false;
+
+    // Backend headers end 8 byte aligned, so the offsets can be read straight from the page
+    uint64_t *offsets = (uint64_t *)(base + offsets_start);
+    if (offsets[0] != 0 || offsets[chunks] > file_size - data_start) return false;
+
+    const uint64_t data_end = data_start + offsets[chunks];
+    const uint64_t summary_end = data_end + 2 * chunks;
+    if (data_end != file_size && summary_end != file_size && summary_end + sizeof(uint64_t) != file_size) return false;
+
+    // A bound probe trusts its summary without reading the block, so summaries count only with a matching hash
+    int8_t *bounds = NULL;
+    if (summary_end + sizeof(uint64_t) == file_size) {
+        uint64_t hash;
+        memcpy(&hash, base + summary_end, sizeof(hash));
+        if (egdbHashBytes(base + data_end, 2 * chunks) == hash) bounds = (int8_t *)(base + data_end);
+    }
+
+    layer->compressed = true;
+    layer->data = base + data_start;
+    layer->offsets = offsets;
+    layer->bytes = offsets[chunks];
+    layer->chunks = chunks;
+    layer->bounds = bounds;
+    layer->map = base;
+    layer->map_size = file_size;
+    return true;
+}
+
+bool writeBlockSections(FILE *f, const EGDBBlockLayer *layer) {
+    const uint64_t chunks = layer->chunks;
+
+    bool ok = fwrite(layer->offsets, sizeof(uint64_t), chunks + 1, f) == chunks + 1;
+    ok = ok && fwrite(layer->data, 1, layer->bytes, f) == layer->bytes;
+    if (!layer->bounds) return ok;
+
+    uint64_t hash = egdbHashBytes(layer->bounds, 2 * chunks);
+    ok = ok && fwrite(layer->bounds, 1, 2 * chunks, f) == 2 * chunks;
+    return ok && fwrite(&hash, sizeof(hash), 1, f) == 1;
+}
+
+bool adoptBlockFile(EGDBBlockLayer *layer, int s, uint64_t size, bool is_avalanche, bool (*map)(int s, uint64_t size, bool is_avalanche)) {
+    EGDBBlockLayer own = *layer;
+
+    // Same content, so cached blocks of the layer stay valid
+    memset(layer, 0, sizeof(*layer));
+    if (!map(s, size, is_avalanche)) {
+        *layer = own;
+        return false;
+    }
+
+    free(own.data);
+    free(own.offsets);
+    free(own.bounds);
+    free(own.dict);
+    return true;
+}
+
+// Offsets of a mapped file are only checked here, a damaged one must not read past the payload
+static bool decodeLayerBlock(const EGDBBlockLayer *layer, int s, uint64_t chunk_id, int8_t *block, EGDBBlockDecoder decode) {
+    const uint64_t start = layer->offsets[chunk_id];
+    const uint64_t end = layer->offsets[chunk_id + 1];
+    if (end < start || end > layer->bytes) return false;
+
+    if (!decode(s, &layer->data[start], end - start, block)) return false;
+    storeCachedBlock(s, chunk_id, block);
+    return true;
+}
+
+bool probeBlockLayer(const EGDBBlockLayer *layer, int s, uint64_t idx, int8_t *val, EGDBBlockDecoder decode) {
+    const uint64_t chunk_id = idx / EGDB_CACHE_BLOCK_SIZE;
+    const uint64_t offset = idx % EGDB_CACHE_BLOCK_SIZE;
+    if (readCachedBlock(s, chunk_id, &offset, 1, val)) return true;
+
+    int8_t block[EGDB_CACHE_BLOCK_SIZE];
+    if (!decodeLayerBlock(layer, s, chunk_id, block, decode)) return false;
+
+    *val = block[offset];
+    return true;
+}
+
+bool probeBlockLayerBound(const EGDBBlockLayer *layer, uint64_t idx, int8_t *lower, int8_t *upper) {
+    if (!layer->bounds) return false;
+
+    const uint64_t chunk_id = idx / EGDB_CACHE_BLOCK_SIZE;
+    *lower = layer->bounds[2 * chunk_id];
+    *upper = layer->bounds[2 * chunk_id + 1];
+    return true;
+}
+
+bool probeBlockLayerBatch(const EGDBBlockLayer *layer, int s, const uint64_t *idx, int8_t *vals, int count, EGDBBlockDecoder decode) {
+    int8_t block[EGDB_CACHE_BLOCK_SIZE];
+    uint64_t offsets[EGDB_CACHE_BLOCK_SIZE];
+
+    for (int k = 0; k < count;) {
+        const uint64_t chunk_id = idx[k] / EGDB_CACHE_BLOCK_SIZE;
+
+        // Indices of the same block follow each other, all of them are read with one lookup
+        int run = 0;
+        while (k + run < count && idx[k + run] / EGDB_CACHE_BLOCK_SIZE == chunk_id) {
+            if (run < EGDB_CACHE_BLOCK_SIZE) offsets[run] = idx[k + run] % EGDB_CACHE_BLOCK_SIZE;
+            run++;
+        }
+
+        if (run > EGDB_CACHE_BLOCK_SIZE || !readCachedBlock(s, chunk_id, offsets, run, &vals[k])) {
+            if (!decodeLayerBlock(layer, s, chunk_id, block, decode)) return false;
+            for (int r = 0; r < run; r++) {
+                vals[k + r] = block[idx[k + r] % EGDB_CACHE_BLOCK_SIZE];
+            }
+        }
+        k += run;
+    }
+    return true;
+}
+
+uint64_t blockLayerBytes(const EGDBBlockLayer *layer) {
+    return layer->bytes + (layer->chunks + 1) * sizeof(uint64_t) + layer->dict_size;
+}
+
+void egdb_mem_get_cache_stats(uint64_t *hits, uint64_t *misses, uint64_t *bytes) {
+    *hits = 0;
+    *misses = 0;
+    *bytes = 0;
+    if (!blockCacheReady) return;
+
+    for (int i = 0; i < EGDB_CACHE_SHARDS; i++) {
+        *hits += __atomic_load_n(&blockCache[i].hits, __ATOMIC_RELAXED);
+        *misses += __atomic_load_n(&blockCache[i].misses, __ATOMIC_RELAXED);
+    }
+    *bytes = (uint64_t)EGDB_CACHE_SHARDS * blockCacheSets * sizeof(BlockCacheSet);
+}
+
+void egdb_mem_reset_cache_stats(void) {
+    if (!blockCacheReady) return;
+
+    for (int i = 0; i < EGDB_CACHE_SHARDS; i++) {
+        __atomic_store_n(&blockCache[i].hits, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&blockCache[i].misses, 0, __ATOMIC_RELAXED);
+    }
+}
+
+bool egdb_mem_set_cache_size(uint64_t bytes) {
+    return setBlockCacheBytes(bytes);
+}
+
+uint64_t egdb_mem_get_cache_size(void) {
+    return getBlockCacheBytes();
+}
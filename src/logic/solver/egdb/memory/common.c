@@ -0,0 +1,114 @@
+/**
+ * Copyright (c) Alexander Kurtz 2026
+ */
+
+#include "logic/solver/egdb/common.h"
+#include "logic/solver/egdb/core.h"
+
+#if !defined(_WIN32) && !defined(WEB_BUILD)
+#include <sys/mman.h>
+#include <fcntl.h>
+#endif
+
+static inline uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+uint64_t egdbHashBytes(const void *data, uint64_t size) {
+    const uint8_t *bytes = data;
+    uint64_t h = 0x9E3779B97F4A7C15ULL ^ size;
+
+    uint64_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, bytes + i, 8);
+        h ^= word * 0x87C37B91114253D5ULL;
+        h = rotl64(h, 31) * 0x4CF5AD432745937FULL;
+    }
+    for (; i < size; i++) {
+        h ^= bytes[i] * 0x87C37B91114253D5ULL;
+        h = rotl64(h, 31) * 0x4CF5AD432745937FULL;
+    }
+
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    return h;
+}
+
+typedef struct {
+    const void *data;
+    uint64_t size;
+} EGDBBuffer;
+
+static bool writeBuffer(FILE *f, void *context) {
+    const EGDBBuffer *buffer = context;
+    return fwrite(buffer->data, 1, buffer->size, f) == buffer->size;
+}
+
+bool egdbWriteFile(const char *path, const void *data, uint64_t size) {
+    EGDBBuffer buffer = {data, size};
+    return writeFileReplacing(path, writeBuffer, &buffer);
+}
+
+#if !defined(_WIN32) && !defined(WEB_BUILD)
+uint8_t *egdbMapFile(const char *path, uint64_t min_size, uint64_t *file_size) {
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0 || (uint64_t)st.st_size < min_size) {
+        close(fd);
+        return NULL;
+    }
+
+    // The descriptor is not needed once the mapping exists
+    void *mapped = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) return NULL;
+
+    *file_size = (uint64_t)st.st_size;
+    return mapped;
+}
+#endif
+
+bool egdbPlainSave(int s, uint64_t size, bool is_avalanche) {
+    char bin_filename[256];
+    char bnd_filename[256];
+    snprintf(bin_filename, sizeof(bin_filename), "EGDB/egdb_%s%d.bin", is_avalanche ? "av_" : "", s);
+    snprintf(bnd_filename, sizeof(bnd_filename), "EGDB/egdb_%s%d.bnd", is_avalanche ? "av_" : "", s);
+
+    if (!egdb_tables[s]) return false;
+
+    // Gone before the .bin changes, so no crash leaves summaries of the old values next to the new ones
+    remove(bnd_filename);
+    return egdbWriteFile(bin_filename, egdb_tables[s], size);
+}
+
+bool egdbPlainCheckpoint(int s, uint64_t size, bool is_avalanche) {
+    char tmp_filename[256];
+    snprintf(tmp_filename, sizeof(tmp_filename), "EGDB/egdb_%s%d.bin.tmp", is_avalanche ? "av_" : "", s);
+
+    // Written next to the previous checkpoint, which stays intact until the rename
+    if (!egdb_tables[s]) return false;
+    return egdbWriteFile(tmp_filename, egdb_tables[s], size);
+}
+
+bool egdbPlainResume(int s, uint64_t size, bool is_avalanche) {
+    char tmp_filename[256];
+    snprintf(tmp_filename, sizeof(tmp_filename), "EGDB/egdb_%s%d.bin.tmp", is_avalanche ? "av_" : "", s);
+
+    FILE *f = fopen(tmp_filename, "rb");
+    if (!f) return false;
+
+    egdb_tables[s] = malloc(size);
+    if (!egdb_tables[s] || fread(egdb_tables[s], 1, size, f) != size) {
+        free(egdb_tables[s]);
+        egdb_tables[s] = NULL;
+        fclose(f);
+        return false;
+    }
+
+    fclose(f);
+    return true;
+}
@@ -4,6 +4,7 @@
 
 #include "logic/solver/egdb/core.h"
 #include "logic/solver/egdb/egdb_mem.h"
+#include "logic/solver/egdb/common.h"
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -40,20 +41,23 @@ bool egdb_mem_load(int s, uint64_t size, bool is_avalanche) {
     return true;
 }
 
-void egdb_mem_alloc(int s, uint64_t size) {
+void egdb_mem_alloc(int s, uint64_t size, bool is_avalanche) {
+    (void)is_avalanche;
+
     egdb_tables[s] = malloc(size);
 }
 
-void egdb_mem_save(int s, uint64_t size, bool is_avalanche) {
-    char bin_filename[256];
-    snprintf(bin_filename, sizeof(bin_filename), "EGDB/egdb_%s%d.bin", is_avalanche ? "av_" : "", s);
-
+bool egdb_mem_save(int s, uint64_t size, bool is_avalanche) {
     // Save directly to raw binary
-    FILE *f_out = fopen(bin_filename, "wb");
-    if (f_out) {
-        fwrite(egdb_tables[s], 1, size, f_out);
-        fclose(f_out);
-    }
+    return egdbPlainSave(s, size, is_avalanche);
+}
+
+bool egdb_mem_checkpoint(int s, uint64_t size, bool is_avalanche) {
+    return egdbPlainCheckpoint(s, size, is_avalanche);
+}
+
+bool egdb_mem_resume(int s, uint64_t size, bool is_avalanche) {
+    return egdbPlainResume(s, size, is_avalanche);
 }
 
 void egdb_mem_free_layer(int s, uint64_t size) {
@@ -65,6 +69,12 @@ void egdb_mem_free_layer(int s, uint64_t size) {
     }
 }
 
+void egdb_mem_remove(int s, bool is_avalanche) {
+    // Only the .bin, which the caller deletes
+    (void)s;
+    (void)is_avalanche;
+}
+
 bool egdb_mem_probe(int s, uint64_t idx, int8_t *val) {
     // Array lookup since layer is uncompressed in memory
     if (egdb_tables[s]) {
@@ -75,7 +85,42 @@ bool egdb_mem_probe(int s, uint64_t idx, int8_t *val) {
     return false;
 }
 
+// Values are read straight from RAM, a summary would not save anything
+bool egdb_mem_probe_bound(int s, uint64_t idx, int8_t *lower, int8_t *upper) {
+    (void)s;
+    (void)idx;
+    (void)lower;
+    (void)upper;
+    return false;
+}
+
+bool egdb_mem_probe_batch(int s, const uint64_t *idx, int8_t *vals, int count) {
+    if (!egdb_tables[s]) return false;
+
+    for (int k = 0; k < count; k++) {
+        vals[k] = egdb_tables[s][idx[k]];
+    }
+    return true;
+}
+
 uint64_t egdb_mem_get_size(int s, uint64_t size_uncompressed) {
     if (egdb_tables[s]) return size_uncompressed;
     return 0;
 }
+
+void egdb_mem_get_cache_stats(uint64_t *hits, uint64_t *misses, uint64_t *bytes) {
+    *hits = 0;
+    *misses = 0;
+    *bytes = 0;
+}
+
+void egdb_mem_reset_cache_stats(void) {}
+
+bool egdb_mem_set_cache_size(uint64_t bytes) {
+    (void)bytes;
+    return false;
+}
+
+uint64_t egdb_mem_get_cache_size(void) {
+    return 0;
+}
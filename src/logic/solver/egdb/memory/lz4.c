@@ -4,253 +4,200 @@
 
 #include "logic/solver/egdb/core.h"
 #include "logic/solver/egdb/egdb_mem.h"
+#include "logic/solver/egdb/common.h"
+#include "logic/solver/egdb/block_cache.h"
 
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 #include <sys/mman.h>
-#include <fcntl.h>
 #include <unistd.h>
 #include <lz4.h>
 #include <lz4hc.h>
 
 #define EGDB_LZ4_MAGIC 0x48435A4C
-#define EGDB_LZ4_BLOCK_SIZE 1024
+#define EGDB_LZ4_BLOCK_SIZE EGDB_CACHE_BLOCK_SIZE
 
-static bool egdb_is_compressed[EGDB_MAX_STONES + 1] = {false};
-static uint8_t *egdb_comp_data[EGDB_MAX_STONES + 1] = {NULL};
-static uint64_t *egdb_comp_offsets[EGDB_MAX_STONES + 1] = {NULL};
+// Magic, block size, chunk count and uncompressed size, followed by the block layer sections
+#define EGDB_LZ4_HEADER_SIZE 24
 
-void egdb_mem_init(void) {}
+static EGDBBlockLayer egdb_layers[EGDB_MAX_STONES + 1];
 
-static bool compressBufferToRuntime(int s, int8_t *raw_data, uint64_t size) {
-    uint32_t block_size = EGDB_LZ4_BLOCK_SIZE;
-    uint64_t num_chunks = (size + block_size - 1) / block_size;
-
-    // Reset offsets list for layer
-    if (egdb_comp_offsets[s]) free(egdb_comp_offsets[s]);
-    egdb_comp_offsets[s] = malloc((num_chunks + 1) * sizeof(uint64_t));
-    if (!egdb_comp_offsets[s]) return false;
-
-    // Estimate worst-case size for target buffer
-    uint64_t max_dest_size = num_chunks * (uint64_t)LZ4_compressBound(block_size);
-    uint8_t *temp_comp_buffer = malloc(max_dest_size);
-    if (!temp_comp_buffer) {
-        free(egdb_comp_offsets[s]);
-        egdb_comp_offsets[s] = NULL;
-        return false;
-    }
-
-    void *lz4State = malloc(LZ4_sizeofStateHC());
-    uint64_t current_offset = 0;
-
-    // Compress chunk by chunk
-    for (uint64_t i = 0; i < num_chunks; i++) {
-        egdb_comp_offsets[s][i] = current_offset;
+static void lz4FileName(char *buffer, size_t size, int s, bool is_avalanche) {
+    snprintf(buffer, size, "EGDB/egdb_%s%d.lz4db", is_avalanche ? "av_" : "", s);
+}
 
-        uint64_t start_idx = i * block_size;
-        int chunk_bytes = block_size;
+static bool decodeBlock(int s, const uint8_t *src, uint64_t bytes, int8_t *block) {
+    (void)s;
+    return LZ4_decompress_safe((const char *)src, (char *)block, (int)bytes, EGDB_LZ4_BLOCK_SIZE) > 0;
+}
 
-        // Handle last chunk size
-        if (start_idx + chunk_bytes > size) {
-            chunk_bytes = (int)(size - start_idx);
-        }
+static uint64_t encodeBlock(void *context, const int8_t *src, uint64_t bytes, uint8_t *dst, uint64_t capacity) {
+    int written = LZ4_compress_HC_extStateHC(context, (const char *)src, (char *)dst, (int)bytes, (int)capacity, LZ4HC_CLEVEL_MAX);
+    return written > 0 ? (uint64_t)written : 0;
+}
 
-        int comp_bytes = LZ4_compress_HC_extStateHC(
-            lz4State,
-            (const char *)&raw_data[start_idx],
-            (char *)&temp_comp_buffer[current_offset],
-            chunk_bytes,
-            LZ4_compressBound(chunk_bytes),
-            LZ4HC_CLEVEL_MAX);
+void egdb_mem_init(void) {
+    initBlockCache();
+}
 
-        current_offset += comp_bytes;
+// Only the header and the total size are checked up front
+static bool mapCompressedFile(int s, uint64_t size, bool is_avalanche) {
+    char lz4_filename[256];
+    lz4FileName(lz4_filename, sizeof(lz4_filename), s, is_avalanche);
+
+    uint64_t file_size;
+    uint8_t *base = egdbMapFile(lz4_filename, EGDB_LZ4_HEADER_SIZE, &file_size);
+    if (!base) return false;
+
+    uint32_t magic, b_size;
+    uint64_t num_chunks, uncomp_size;
+    memcpy(&magic, base, 4);
+    memcpy(&b_size, base + 4, 4);
+    memcpy(&num_chunks, base + 8, 8);
+    memcpy(&uncomp_size, base + 16, 8);
+
+    bool ok = magic == EGDB_LZ4_MAGIC && b_size == EGDB_LZ4_BLOCK_SIZE && num_chunks == blockLayerChunks(size) &&
+              uncomp_size == size;
+    if (!ok || !attachBlockFile(&egdb_layers[s], base, file_size, EGDB_LZ4_HEADER_SIZE, num_chunks)) {
+        munmap(base, file_size);
+        return false;
     }
+    return true;
+}
 
-    egdb_comp_offsets[s][num_chunks] = current_offset;
-    free(lz4State);
-
-    // Minimize final buffer footprint
-    if (egdb_comp_data[s]) free(egdb_comp_data[s]);
-    egdb_comp_data[s] = malloc(current_offset);
+static bool compressBufferToRuntime(int s, const int8_t *raw_data, uint64_t size) {
+    releaseBlockLayer(&egdb_layers[s], s);
 
-    if (egdb_comp_data[s]) {
-        memcpy(egdb_comp_data[s], temp_comp_buffer, current_offset);
-        egdb_is_compressed[s] = true;
-    } else {
-        egdb_is_compressed[s] = false;
-    }
+    void *lz4State = malloc(LZ4_sizeofStateHC());
+    if (!lz4State) return false;
 
-    free(temp_comp_buffer);
-    return egdb_is_compressed[s];
+    bool ok = compressBlockLayer(&egdb_layers[s], raw_data, size, LZ4_compressBound(EGDB_LZ4_BLOCK_SIZE), encodeBlock, lz4State);
+    free(lz4State);
+    return ok;
 }
 
-static void saveCompressedRuntimeToDisk(int s, uint64_t uncomp_size, bool is_avalanche) {
-    char lz4_filename[256];
-    snprintf(lz4_filename, sizeof(lz4_filename), "EGDB/egdb_%s%d.lz4db", is_avalanche ? "av_" : "", s);
-
-    FILE *f_out = fopen(lz4_filename, "wb");
-    if (!f_out) return;
+typedef struct {
+    int stones;
+    uint64_t size;
+} CompressedFile;
 
+static bool writeCompressedContents(FILE *f, void *context) {
+    const CompressedFile *file = context;
+    const EGDBBlockLayer *layer = &egdb_layers[file->stones];
     uint32_t magic = EGDB_LZ4_MAGIC;
     uint32_t b_size = EGDB_LZ4_BLOCK_SIZE;
-    uint64_t num_chunks = (uncomp_size + b_size - 1) / b_size;
-    uint64_t comp_size = egdb_comp_offsets[s][num_chunks];
 
-    // Write file metadata and chunk headers
-    fwrite(&magic, 4, 1, f_out);
-    fwrite(&b_size, 4, 1, f_out);
-    fwrite(&num_chunks, 8, 1, f_out);
-    fwrite(&uncomp_size, 8, 1, f_out);
+    bool ok = fwrite(&magic, 4, 1, f) == 1;
+    ok = ok && fwrite(&b_size, 4, 1, f) == 1;
+    ok = ok && fwrite(&layer->chunks, 8, 1, f) == 1;
+    ok = ok && fwrite(&file->size, 8, 1, f) == 1;
+    return ok && writeBlockSections(f, layer);
+}
 
-    // Flush arrays
-    fwrite(egdb_comp_offsets[s], 8, num_chunks + 1, f_out);
-    fwrite(egdb_comp_data[s], 1, comp_size, f_out);
+static bool saveCompressedRuntimeToDisk(int s, uint64_t uncomp_size, bool is_avalanche) {
+    char lz4_filename[256];
+    lz4FileName(lz4_filename, sizeof(lz4_filename), s, is_avalanche);
 
-    fclose(f_out);
+    CompressedFile file = {s, uncomp_size};
+    return writeFileReplacing(lz4_filename, writeCompressedContents, &file);
 }
 
 bool egdb_mem_load(int s, uint64_t size, bool is_avalanche) {
-    char lz4_filename[256];
-    snprintf(lz4_filename, sizeof(lz4_filename), "EGDB/egdb_%s%d.lz4db", is_avalanche ? "av_" : "", s);
-
-    // Try loading native compressed format first
-    if (access(lz4_filename, F_OK) == 0) {
-        FILE *f_lz4 = fopen(lz4_filename, "rb");
-        if (f_lz4) {
-            uint32_t magic;
-
-            // Validate signature
-            if (fread(&magic, 4, 1, f_lz4) == 1 && magic == EGDB_LZ4_MAGIC) {
-                uint32_t f_bsize;
-                uint64_t num_chunks, uncomp_size;
-                bool ok = true;
-
-                if (fread(&f_bsize, 4, 1, f_lz4) != 1) ok = false;
-                if (ok && fread(&num_chunks, 8, 1, f_lz4) != 1) ok = false;
-                if (ok && fread(&uncomp_size, 8, 1, f_lz4) != 1) ok = false;
-
-                if (ok) {
-                    egdb_comp_offsets[s] = malloc((num_chunks + 1) * sizeof(uint64_t));
-                    if (fread(egdb_comp_offsets[s], 8, num_chunks + 1, f_lz4) != (num_chunks + 1)) {
-                        ok = false;
-                    }
-                }
-
-                if (ok) {
-                    uint64_t comp_size = egdb_comp_offsets[s][num_chunks];
-                    egdb_comp_data[s] = malloc(comp_size);
-                    if (fread(egdb_comp_data[s], 1, comp_size, f_lz4) != comp_size) {
-                        ok = false;
-                    }
-                }
-
-                if (ok) {
-                    egdb_is_compressed[s] = true;
-                    fclose(f_lz4);
-                    return true;
-                } else {
-                    if (egdb_comp_offsets[s]) {
-                        free(egdb_comp_offsets[s]);
-                        egdb_comp_offsets[s] = NULL;
-                    }
-                    if (egdb_comp_data[s]) {
-                        free(egdb_comp_data[s]);
-                        egdb_comp_data[s] = NULL;
-                    }
-                }
-            }
-            fclose(f_lz4);
-        }
-    }
-
-    // Fallback: If only raw .bin exists, load, compress, save to lz4db
     char bin_filename[256];
     snprintf(bin_filename, sizeof(bin_filename), "EGDB/egdb_%s%d.bin", is_avalanche ? "av_" : "", s);
 
-    if (access(bin_filename, F_OK) == 0) {
-        int fd = open(bin_filename, O_RDONLY);
-        if (fd != -1) {
-            void *mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
-            close(fd);
-
-            if (mapped != MAP_FAILED) {
-                compressBufferToRuntime(s, (int8_t *)mapped, size);
-                munmap(mapped, size);
-                saveCompressedRuntimeToDisk(s, size, is_avalanche);
-                return true;
-            }
-        }
+    // Try mapping the native compressed format first, a file without block summaries is rebuilt if it can be
+    if (mapCompressedFile(s, size, is_avalanche)) {
+        if (egdb_layers[s].bounds || access(bin_filename, F_OK) != 0) return true;
+        releaseBlockLayer(&egdb_layers[s], s);
     }
 
-    return false;
+    // Fallback: If only raw .bin exists (or the .lz4db does not match), compress it and save to lz4db
+    uint64_t bin_size;
+    uint8_t *mapped = egdbMapFile(bin_filename, size, &bin_size);
+    if (!mapped) return false;
+
+    bool ok = compressBufferToRuntime(s, (const int8_t *)mapped, size);
+    munmap(mapped, bin_size);
+    if (ok && saveCompressedRuntimeToDisk(s, size, is_avalanche)) {
+        adoptBlockFile(&egdb_layers[s], s, size, is_avalanche, mapCompressedFile);
+    }
+    return ok;
 }
 
-void egdb_mem_alloc(int s, uint64_t size) {
+void egdb_mem_alloc(int s, uint64_t size, bool is_avalanche) {
+    (void)is_avalanche;
+
+    releaseBlockLayer(&egdb_layers[s], s);
     egdb_tables[s] = malloc(size);
-    egdb_is_compressed[s] = false;
 }
 
-void egdb_mem_save(int s, uint64_t size, bool is_avalanche) {
-    char bin_filename[256];
-    snprintf(bin_filename, sizeof(bin_filename), "EGDB/egdb_%s%d.bin", is_avalanche ? "av_" : "", s);
-
+bool egdb_mem_save(int s, uint64_t size, bool is_avalanche) {
     // Write out raw binary first
-    FILE *f_out = fopen(bin_filename, "wb");
-    if (f_out) {
-        fwrite(egdb_tables[s], 1, size, f_out);
-        fclose(f_out);
-    }
+    bool ok = egdbPlainSave(s, size, is_avalanche);
 
-    // Convert internal state to compressed for remaining runtime
-    if (compressBufferToRuntime(s, egdb_tables[s], size)) {
-        saveCompressedRuntimeToDisk(s, size, is_avalanche);
+    // Convert internal state to compressed for remaining runtime, a missing file is rebuilt from the .bin on load
+    ok = ok && compressBufferToRuntime(s, egdb_tables[s], size);
+    if (ok && saveCompressedRuntimeToDisk(s, size, is_avalanche)) {
+        adoptBlockFile(&egdb_layers[s], s, size, is_avalanche, mapCompressedFile);
     }
 
     free(egdb_tables[s]);
     egdb_tables[s] = NULL;
+    return ok;
+}
+
+bool egdb_mem_checkpoint(int s, uint64_t size, bool is_avalanche) {
+    return egdbPlainCheckpoint(s, size, is_avalanche);
+}
+
+bool egdb_mem_resume(int s, uint64_t size, bool is_avalanche) {
+    releaseBlockLayer(&egdb_layers[s], s);
+    return egdbPlainResume(s, size, is_avalanche);
 }
 
 void egdb_mem_free_layer(int s, uint64_t size) {
     (void)size;
 
-    if (egdb_is_compressed[s]) {
-        free(egdb_comp_data[s]);
-        free(egdb_comp_offsets[s]);
+    releaseBlockLayer(&egdb_layers[s], s);
 
-        egdb_comp_data[s] = NULL;
-        egdb_comp_offsets[s] = NULL;
-        egdb_is_compressed[s] = false;
+    // Plain table of a layer still in generation
+    if (egdb_tables[s]) {
+        free(egdb_tables[s]);
+        egdb_tables[s] = NULL;
     }
 }
 
-bool egdb_mem_probe(int s, uint64_t idx, int8_t *val) {
-    if (egdb_is_compressed[s]) {
-        // Calculate bounds in chunk map
-        uint64_t chunk_id = idx / EGDB_LZ4_BLOCK_SIZE;
-        uint64_t offset_in_chunk = idx % EGDB_LZ4_BLOCK_SIZE;
-
-        uint64_t comp_offset = egdb_comp_offsets[s][chunk_id];
-        int comp_size = (int)(egdb_comp_offsets[s][chunk_id + 1] - comp_offset);
+void egdb_mem_remove(int s, bool is_avalanche) {
+    char lz4_filename[256];
+    lz4FileName(lz4_filename, sizeof(lz4_filename), s, is_avalanche);
+    remove(lz4_filename);
+}
 
-        // Fetch partial chunk safely to save decompression cycles
-        int target = (int)(offset_in_chunk + 1);
-        int8_t temp_buf[EGDB_LZ4_BLOCK_SIZE];
+bool egdb_mem_probe(int s, uint64_t idx, int8_t *val) {
+    if (egdb_layers[s].compressed) {
+        return probeBlockLayer(&egdb_layers[s], s, idx, val, decodeBlock);
+    } else if (egdb_tables[s]) {
+        // Uncompressed cache hit
+        *val = egdb_tables[s][idx];
+        return true;
+    }
 
-        int decompressed = LZ4_decompress_safe_partial(
-            (const char *)&egdb_comp_data[s][comp_offset],
-            (char *)temp_buf,
-            comp_size,
-            target,
-            EGDB_LZ4_BLOCK_SIZE);
+    return false;
+}
 
-        if (decompressed < target) return false;
+bool egdb_mem_probe_bound(int s, uint64_t idx, int8_t *lower, int8_t *upper) {
+    return egdb_layers[s].compressed && probeBlockLayerBound(&egdb_layers[s], idx, lower, upper);
+}
 
-        *val = temp_buf[offset_in_chunk];
-        return true;
+bool egdb_mem_probe_batch(int s, const uint64_t *idx, int8_t *vals, int count) {
+    if (egdb_layers[s].compressed) {
+        return probeBlockLayerBatch(&egdb_layers[s], s, idx, vals, count, decodeBlock);
     } else if (egdb_tables[s]) {
-        // Uncompressed cache hit
-        *val = egdb_tables[s][idx];
+        for (int k = 0; k < count; k++) {
+            vals[k] = egdb_tables[s][idx[k]];
+        }
         return true;
     }
 
@@ -258,9 +205,8 @@ bool egdb_mem_probe(int s, uint64_t idx, int8_t *val) {
 }
 
 uint64_t egdb_mem_get_size(int s, uint64_t size_uncompressed) {
-    if (egdb_is_compressed[s]) {
-        uint64_t num_chunks = (size_uncompressed + EGDB_LZ4_BLOCK_SIZE - 1) / EGDB_LZ4_BLOCK_SIZE;
-        return egdb_comp_offsets[s][num_chunks] + (num_chunks + 1) * sizeof(uint64_t);
+    if (egdb_layers[s].compressed) {
+        return blockLayerBytes(&egdb_layers[s]);
     } else if (egdb_tables[s]) {
         return size_uncompressed;
     }
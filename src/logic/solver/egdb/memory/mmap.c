@@ -4,32 +4,144 @@
 
 #include "logic/solver/egdb/core.h"
 #include "logic/solver/egdb/egdb_mem.h"
+#include "logic/solver/egdb/common.h"
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <sys/mman.h>
 #include <fcntl.h>
 #include <unistd.h>
 
 static bool egdb_is_mmapped[EGDB_MAX_STONES + 1] = {false};
 
+// Layer mapped writable onto its temporary file while it is generated
+static bool egdb_is_generating[EGDB_MAX_STONES + 1] = {false};
+
+/**
+ * Block summaries for bound probes in EGDB/egdb_N.bnd: magic, block size, positions, the inode
+ * and modification time of the .bin they were taken from and a hash of the summaries, then the
+ * smallest and largest value of every page of the layer. They are a 2048th of the layer and stay
+ * resident, so a probe that the summary decides never faults in the page of its value. A .bin
+ * replaced since, or summaries that don't match their hash, get new summaries.
+ */
+#define EGDB_BOUND_MAGIC 0x33444E42 // "BND3"
+#define EGDB_BOUND_BLOCK_SIZE 4096
+#define EGDB_BOUND_HEADER_SIZE 40
+
+static int8_t *egdb_bounds_map[EGDB_MAX_STONES + 1] = {NULL};
+static uint64_t egdb_bounds_map_size[EGDB_MAX_STONES + 1] = {0};
+
+static void layerFileName(char *buffer, size_t size, int s, bool is_avalanche, const char *suffix) {
+    snprintf(buffer, size, "EGDB/egdb_%s%d.bin%s", is_avalanche ? "av_" : "", s, suffix);
+}
+
+static void boundFileName(char *buffer, size_t size, int s, bool is_avalanche) {
+    snprintf(buffer, size, "EGDB/egdb_%s%d.bnd", is_avalanche ? "av_" : "", s);
+}
+
+static void releaseBoundFile(int s) {
+    if (egdb_bounds_map[s]) munmap(egdb_bounds_map[s], egdb_bounds_map_size[s]);
+    egdb_bounds_map[s] = NULL;
+    egdb_bounds_map_size[s] = 0;
+}
+
+static bool mapBoundFile(int s, uint64_t size, bool is_avalanche, const struct stat *bin) {
+    char bnd_filename[256];
+    boundFileName(bnd_filename, sizeof(bnd_filename), s, is_avalanche);
+
+    uint64_t blocks = (size + EGDB_BOUND_BLOCK_SIZE - 1) / EGDB_BOUND_BLOCK_SIZE;
+    uint64_t file_size = EGDB_BOUND_HEADER_SIZE + 2 * blocks;
+
+    uint64_t mapped_size;
+    uint8_t *mapped = egdbMapFile(bnd_filename, file_size, &mapped_size);
+    if (!mapped) return false;
+
+    uint32_t magic, block_size;
+    uint64_t positions, inode, hash;
+    int64_t mtime;
+    memcpy(&magic, mapped, 4);
+    memcpy(&block_size, mapped + 4, 4);
+    memcpy(&positions, mapped + 8, 8);
+    memcpy(&inode, mapped + 16, 8);
+    memcpy(&mtime, mapped + 24, 8);
+    memcpy(&hash, mapped + 32, 8);
+    if (mapped_size != file_size || magic != EGDB_BOUND_MAGIC || block_size != EGDB_BOUND_BLOCK_SIZE ||
+        positions != size || inode != (uint64_t)bin->st_ino || mtime != (int64_t)bin->st_mtime ||
+        hash != egdbHashBytes(mapped + EGDB_BOUND_HEADER_SIZE, 2 * blocks)) {
+        munmap(mapped, mapped_size);
+        return false;
+    }
+
+    egdb_bounds_map[s] = (int8_t *)mapped;
+    egdb_bounds_map_size[s] = file_size;
+    return true;
+}
+
+typedef struct {
+    uint64_t size;
+    const struct stat *bin;
+    const int8_t *bounds;
+    uint64_t blocks;
+} BoundFile;
+
+static bool writeBoundContents(FILE *f, void *context) {
+    const BoundFile *file = context;
+    uint32_t magic = EGDB_BOUND_MAGIC;
+    uint32_t block_size = EGDB_BOUND_BLOCK_SIZE;
+    uint64_t inode = (uint64_t)file->bin->st_ino;
+    int64_t mtime = (int64_t)file->bin->st_mtime;
+    uint64_t hash = egdbHashBytes(file->bounds, 2 * file->blocks);
+
+    bool ok = fwrite(&magic, 4, 1, f) == 1;
+    ok = ok && fwrite(&block_size, 4, 1, f) == 1;
+    ok = ok && fwrite(&file->size, 8, 1, f) == 1;
+    ok = ok && fwrite(&inode, 8, 1, f) == 1;
+    ok = ok && fwrite(&mtime, 8, 1, f) == 1;
+    ok = ok && fwrite(&hash, 8, 1, f) == 1;
+    return ok && fwrite(file->bounds, 1, 2 * file->blocks, f) == 2 * file->blocks;
+}
+
+// One sequential pass over the mapped layer
+static bool writeBoundFile(int s, uint64_t size, bool is_avalanche, const struct stat *bin) {
+    char bnd_filename[256];
+    boundFileName(bnd_filename, sizeof(bnd_filename), s, is_avalanche);
+
+    uint64_t blocks = (size + EGDB_BOUND_BLOCK_SIZE - 1) / EGDB_BOUND_BLOCK_SIZE;
+    int8_t *bounds = malloc(2 * blocks);
+    if (!bounds) return false;
+    summarizeEGDBBlocks(egdb_tables[s], size, EGDB_BOUND_BLOCK_SIZE, bounds);
+
+    BoundFile file = {size, bin, bounds, blocks};
+    bool ok = writeFileReplacing(bnd_filename, writeBoundContents, &file);
+    free(bounds);
+    return ok;
+}
+
 void egdb_mem_init(void) {}
 
 bool egdb_mem_load(int s, uint64_t size, bool is_avalanche) {
     char bin_filename[256];
-    snprintf(bin_filename, sizeof(bin_filename), "EGDB/egdb_%s%d.bin", is_avalanche ? "av_" : "", s);
+    layerFileName(bin_filename, sizeof(bin_filename), s, is_avalanche, "");
 
     if (access(bin_filename, F_OK) != 0) return false;
 
     // Open file descriptors and attempt to map it
     int fd = open(bin_filename, O_RDONLY);
     if (fd != -1) {
+        struct stat bin;
+        bool stated = fstat(fd, &bin) == 0;
         void *mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
         close(fd);
 
         if (mapped != MAP_FAILED) {
             egdb_tables[s] = (int8_t *)mapped;
             egdb_is_mmapped[s] = true;
+
+            // Without a .bnd that can be mapped or written bound probes just miss
+            if (stated && !mapBoundFile(s, size, is_avalanche, &bin) && writeBoundFile(s, size, is_avalanche, &bin)) {
+                mapBoundFile(s, size, is_avalanche, &bin);
+            }
             return true;
         }
     }
@@ -37,34 +149,95 @@ bool egdb_mem_load(int s, uint64_t size, bool is_avalanche) {
     return false;
 }
 
-void egdb_mem_alloc(int s, uint64_t size) {
-    // Generate new layers unmapped via generic malloc
-    egdb_tables[s] = malloc(size);
+void egdb_mem_alloc(int s, uint64_t size, bool is_avalanche) {
+    char tmp_filename[256];
+    layerFileName(tmp_filename, sizeof(tmp_filename), s, is_avalanche, ".tmp");
+
+    egdb_tables[s] = NULL;
     egdb_is_mmapped[s] = false;
+    egdb_is_generating[s] = false;
+
+    // Generate straight into the file, the kernel writes pages back once the layer exceeds RAM
+    int fd = open(tmp_filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1) return;
+
+    if (ftruncate(fd, (off_t)size) != 0) {
+        close(fd);
+        unlink(tmp_filename);
+        return;
+    }
+
+    void *mapped = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (mapped == MAP_FAILED) {
+        unlink(tmp_filename);
+        return;
+    }
+
+    egdb_tables[s] = (int8_t *)mapped;
+    egdb_is_mmapped[s] = true;
+    egdb_is_generating[s] = true;
 }
 
-void egdb_mem_save(int s, uint64_t size, bool is_avalanche) {
+bool egdb_mem_save(int s, uint64_t size, bool is_avalanche) {
     char bin_filename[256];
-    snprintf(bin_filename, sizeof(bin_filename), "EGDB/egdb_%s%d.bin", is_avalanche ? "av_" : "", s);
+    char tmp_filename[256];
+    layerFileName(bin_filename, sizeof(bin_filename), s, is_avalanche, "");
+    layerFileName(tmp_filename, sizeof(tmp_filename), s, is_avalanche, ".tmp");
 
-    // Save out fully generated block to file
-    FILE *f_out = fopen(bin_filename, "wb");
-    if (f_out) {
-        fwrite(egdb_tables[s], 1, size, f_out);
-        fclose(f_out);
-    }
+    if (!egdb_tables[s] || !egdb_is_generating[s]) return false;
 
-    // Free volatile allocation
-    free(egdb_tables[s]);
+    // The file only gets its final name once every page is on disk
+    bool synced = msync(egdb_tables[s], size, MS_SYNC) == 0;
+    munmap(egdb_tables[s], size);
     egdb_tables[s] = NULL;
+    egdb_is_mmapped[s] = false;
+    egdb_is_generating[s] = false;
 
-    // Immediately reload layer using efficient mapping
-    int fd = open(bin_filename, O_RDONLY);
-    if (fd != -1) {
-        egdb_tables[s] = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
-        egdb_is_mmapped[s] = true;
+    if (!synced || rename(tmp_filename, bin_filename) != 0) {
+        unlink(tmp_filename);
+        return false;
+    }
+
+    // Summaries of an earlier file of the layer no longer apply, the reload writes new ones
+    char bnd_filename[256];
+    boundFileName(bnd_filename, sizeof(bnd_filename), s, is_avalanche);
+    remove(bnd_filename);
+
+    // Immediately reload layer read only
+    return egdb_mem_load(s, size, is_avalanche);
+}
+
+bool egdb_mem_checkpoint(int s, uint64_t size, bool is_avalanche) {
+    (void)is_avalanche;
+
+    // The layer already lives in its temporary file, it only has to reach the disk
+    if (!egdb_tables[s] || !egdb_is_generating[s]) return false;
+    return msync(egdb_tables[s], size, MS_SYNC) == 0;
+}
+
+bool egdb_mem_resume(int s, uint64_t size, bool is_avalanche) {
+    char tmp_filename[256];
+    layerFileName(tmp_filename, sizeof(tmp_filename), s, is_avalanche, ".tmp");
+
+    int fd = open(tmp_filename, O_RDWR);
+    if (fd == -1) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (uint64_t)st.st_size != size) {
         close(fd);
+        return false;
     }
+
+    void *mapped = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) return false;
+
+    egdb_tables[s] = (int8_t *)mapped;
+    egdb_is_mmapped[s] = true;
+    egdb_is_generating[s] = true;
+    return true;
 }
 
 void egdb_mem_free_layer(int s, uint64_t size) {
@@ -78,7 +251,16 @@ void egdb_mem_free_layer(int s, uint64_t size) {
 
         egdb_tables[s] = NULL;
         egdb_is_mmapped[s] = false;
+        egdb_is_generating[s] = false;
     }
+
+    releaseBoundFile(s);
+}
+
+void egdb_mem_remove(int s, bool is_avalanche) {
+    char bnd_filename[256];
+    boundFileName(bnd_filename, sizeof(bnd_filename), s, is_avalanche);
+    remove(bnd_filename);
 }
 
 bool egdb_mem_probe(int s, uint64_t idx, int8_t *val) {
@@ -90,7 +272,43 @@ bool egdb_mem_probe(int s, uint64_t idx, int8_t *val) {
     return false;
 }
 
+bool egdb_mem_probe_bound(int s, uint64_t idx, int8_t *lower, int8_t *upper) {
+    if (!egdb_tables[s] || !egdb_bounds_map[s]) return false;
+
+    const int8_t *bounds = egdb_bounds_map[s] + EGDB_BOUND_HEADER_SIZE;
+    uint64_t block = idx / EGDB_BOUND_BLOCK_SIZE;
+    *lower = bounds[2 * block];
+    *upper = bounds[2 * block + 1];
+    return true;
+}
+
+bool egdb_mem_probe_batch(int s, const uint64_t *idx, int8_t *vals, int count) {
+    if (!egdb_tables[s]) return false;
+
+    for (int k = 0; k < count; k++) {
+        vals[k] = egdb_tables[s][idx[k]];
+    }
+    return true;
+}
+
 uint64_t egdb_mem_get_size(int s, uint64_t size_uncompressed) {
     if (egdb_tables[s]) return size_uncompressed;
     return 0;
 }
+
+void egdb_mem_get_cache_stats(uint64_t *hits, uint64_t *misses, uint64_t *bytes) {
+    *hits = 0;
+    *misses = 0;
+    *bytes = 0;
+}
+
+void egdb_mem_reset_cache_stats(void) {}
+
+bool egdb_mem_set_cache_size(uint64_t bytes) {
+    (void)bytes;
+    return false;
+}
+
+uint64_t egdb_mem_get_cache_size(void) {
+    return 0;
+}
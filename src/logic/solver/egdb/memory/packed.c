@@ -0,0 +1,313 @@
+/**
+ * Copyright (c) Alexander Kurtz 2026
+ */
+
+#include "logic/solver/egdb/core.h"
+#include "logic/solver/egdb/egdb_mem.h"
+#include "logic/solver/egdb/common.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+
+/**
+ * Packed backend:
+ * A layer with s stones only holds values in [-s, s], so each value is stored in the
+ * ceil(log2(2s + 1)) bits that range needs, biased by 2^(width - 1) to be unsigned. Layers of up
+ * to 7 stones take 4 bits, up to 15 stones 5 bits. A probe reads the 8 bytes around the value and
+ * masks it out, so lookups stay random access without any decompression.
+ *
+ * File layout of EGDB/egdb_N.pkdb (little endian):
+ *   header      magic, width, positions, packed bytes, hash of the values
+ *   values      positions * width bits, followed by 8 bytes of padding for the wide reads
+ *
+ * Generation still fills a plain table, which is packed once the layer is finished.
+ */
+
+#define EGDB_PACKED_MAGIC 0x32444B50 // "PKD2"
+#define EGDB_PACKED_HEADER_SIZE 32
+#define EGDB_PACKED_PADDING 8
+
+static uint8_t *egdb_packed_data[EGDB_MAX_STONES + 1] = {NULL};
+static uint8_t egdb_packed_width[EGDB_MAX_STONES + 1] = {0};
+static uint64_t egdb_packed_bytes[EGDB_MAX_STONES + 1] = {0};
+
+// Layers loaded from a .pkdb point into a read-only shared mapping of the file instead of own buffers
+static uint8_t *egdb_packed_map[EGDB_MAX_STONES + 1] = {NULL};
+static uint64_t egdb_packed_map_size[EGDB_MAX_STONES + 1] = {0};
+
+static void packedFileName(char *buffer, size_t size, int s, bool is_avalanche) {
+    snprintf(buffer, size, "EGDB/egdb_%s%d.pkdb", is_avalanche ? "av_" : "", s);
+}
+
+// Values never leave int8, so 8 bits are the most any layer needs
+static int packedWidth(int s) {
+    int width = 1;
+    while (width < 8 && (1 << width) < 2 * s + 1) width++;
+    return width;
+}
+
+static inline uint64_t packedBytes(uint64_t size, int width) {
+    return (size * (uint64_t)width + 7) / 8 + EGDB_PACKED_PADDING;
+}
+
+static inline int8_t extractValue(const uint8_t *data, int width, uint64_t idx) {
+    const uint64_t bit = idx * (uint64_t)width;
+    uint64_t word;
+    memcpy(&word, &data[bit >> 3], sizeof(word));
+    return (int8_t)((int)((word >> (bit & 7)) & ((1u << width) - 1)) - (1 << (width - 1)));
+}
+
+void egdb_mem_init(void) {}
+
+static void releasePackedLayer(int s) {
+    if (egdb_packed_map[s]) {
+        munmap(egdb_packed_map[s], egdb_packed_map_size[s]);
+        egdb_packed_map[s] = NULL;
+        egdb_packed_map_size[s] = 0;
+    } else {
+        free(egdb_packed_data[s]);
+    }
+
+    egdb_packed_data[s] = NULL;
+    egdb_packed_width[s] = 0;
+    egdb_packed_bytes[s] = 0;
+}
+
+static bool packLayer(int s, const int8_t *raw_data, uint64_t size) {
+    const int width = packedWidth(s);
+    const uint64_t bytes = packedBytes(size, width);
+    const int bias = 1 << (width - 1);
+
+    releasePackedLayer(s);
+
+    uint8_t *data = calloc(bytes, 1);
+    if (!data) return false;
+
+    // Values are or-ed in bit by bit position, at most two bytes are touched per value
+    for (uint64_t idx = 0; idx < size; idx++) {
+        const uint64_t bit = idx * (uint64_t)width;
+        const uint32_t value = (uint32_t)(raw_data[idx] + bias) << (bit & 7);
+        data[bit >> 3] |= (uint8_t)value;
+        data[(bit >> 3) + 1] |= (uint8_t)(value >> 8);
+    }
+
+    egdb_packed_data[s] = data;
+    egdb_packed_width[s] = (uint8_t)width;
+    egdb_packed_bytes[s] = bytes;
+    return true;
+}
+
+/**
+ * Maps a .pkdb read-only and shared, the values are probed in place. A probe has nothing to check
+ * its value against, so the whole file is hashed here once; a damaged file is packed again from
+ * its .bin.
+ */
+static bool mapPackedFile(int s, uint64_t size, bool is_avalanche) {
+    char packed_filename[256];
+    packedFileName(packed_filename, sizeof(packed_filename), s, is_avalanche);
+
+    uint64_t file_size;
+    uint8_t *base = egdbMapFile(packed_filename, EGDB_PACKED_HEADER_SIZE, &file_size);
+    if (!base) return false;
+
+    uint32_t magic, width;
+    uint64_t positions, bytes, hash;
+    memcpy(&magic, base, 4);
+    memcpy(&width, base + 4, 4);
+    memcpy(&positions, base + 8, 8);
+    memcpy(&bytes, base + 16, 8);
+    memcpy(&hash, base + 24, 8);
+
+    const int expected_width = packedWidth(s);
+    if (magic != EGDB_PACKED_MAGIC || width != (uint32_t)expected_width || positions != size ||
+        bytes != packedBytes(size, expected_width) || EGDB_PACKED_HEADER_SIZE + bytes != file_size ||
+        hash != egdbHashBytes(base + EGDB_PACKED_HEADER_SIZE, bytes)) {
+        munmap(base, file_size);
+        return false;
+    }
+
+    egdb_packed_map[s] = base;
+    egdb_packed_map_size[s] = file_size;
+    egdb_packed_data[s] = base + EGDB_PACKED_HEADER_SIZE;
+    egdb_packed_width[s] = (uint8_t)width;
+    egdb_packed_bytes[s] = bytes;
+    return true;
+}
+
+typedef struct {
+    int stones;
+    uint64_t size;
+} PackedFile;
+
+static bool writePackedContents(FILE *f, void *context) {
+    const PackedFile *file = context;
+    uint32_t magic = EGDB_PACKED_MAGIC;
+    uint32_t width = egdb_packed_width[file->stones];
+    uint64_t bytes = egdb_packed_bytes[file->stones];
+    uint64_t hash = egdbHashBytes(egdb_packed_data[file->stones], bytes);
+
+    bool ok = fwrite(&magic, 4, 1, f) == 1;
+    ok = ok && fwrite(&width, 4, 1, f) == 1;
+    ok = ok && fwrite(&file->size, 8, 1, f) == 1;
+    ok = ok && fwrite(&bytes, 8, 1, f) == 1;
+    ok = ok && fwrite(&hash, 8, 1, f) == 1;
+    return ok && fwrite(egdb_packed_data[file->stones], 1, bytes, f) == bytes;
+}
+
+static bool savePackedToDisk(int s, uint64_t size, bool is_avalanche) {
+    char packed_filename[256];
+    packedFileName(packed_filename, sizeof(packed_filename), s, is_avalanche);
+
+    PackedFile file = {s, size};
+    return writeFileReplacing(packed_filename, writePackedContents, &file);
+}
+
+// The packed buffer is only kept while the file just written can not be mapped
+static void adoptPackedFile(int s, uint64_t size, bool is_avalanche) {
+    uint8_t *data = egdb_packed_data[s];
+    uint8_t width = egdb_packed_width[s];
+    uint64_t bytes = egdb_packed_bytes[s];
+
+    egdb_packed_data[s] = NULL;
+    if (mapPackedFile(s, size, is_avalanche)) {
+        free(data);
+        return;
+    }
+
+    egdb_packed_data[s] = data;
+    egdb_packed_width[s] = width;
+    egdb_packed_bytes[s] = bytes;
+}
+
+bool egdb_mem_load(int s, uint64_t size, bool is_avalanche) {
+    // Try mapping the packed format first
+    if (mapPackedFile(s, size, is_avalanche)) return true;
+
+    // Fallback: If only raw .bin exists (or the .pkdb does not match), pack it and save to pkdb
+    char bin_filename[256];
+    snprintf(bin_filename, sizeof(bin_filename), "EGDB/egdb_%s%d.bin", is_avalanche ? "av_" : "", s);
+
+    uint64_t bin_size;
+    uint8_t *mapped = egdbMapFile(bin_filename, size, &bin_size);
+    if (!mapped) return false;
+
+    bool ok = packLayer(s, (const int8_t *)mapped, size);
+    munmap(mapped, bin_size);
+    if (ok && savePackedToDisk(s, size, is_avalanche)) {
+        adoptPackedFile(s, size, is_avalanche);
+    }
+    return ok;
+}
+
+void egdb_mem_alloc(int s, uint64_t size, bool is_avalanche) {
+    (void)is_avalanche;
+
+    releasePackedLayer(s);
+    egdb_tables[s] = malloc(size);
+}
+
+bool egdb_mem_save(int s, uint64_t size, bool is_avalanche) {
+    // Write out raw binary first
+    if (!egdbPlainSave(s, size, is_avalanche)) return false;
+
+    // The plain table is only kept if packing fails
+    if (!packLayer(s, egdb_tables[s], size)) return true;
+    if (savePackedToDisk(s, size, is_avalanche)) adoptPackedFile(s, size, is_avalanche);
+
+    free(egdb_tables[s]);
+    egdb_tables[s] = NULL;
+    return true;
+}
+
+bool egdb_mem_checkpoint(int s, uint64_t size, bool is_avalanche) {
+    return egdbPlainCheckpoint(s, size, is_avalanche);
+}
+
+bool egdb_mem_resume(int s, uint64_t size, bool is_avalanche) {
+    return egdbPlainResume(s, size, is_avalanche);
+}
+
+void egdb_mem_free_layer(int s, uint64_t size) {
+    (void)size;
+
+    releasePackedLayer(s);
+    if (egdb_tables[s]) {
+        free(egdb_tables[s]);
+        egdb_tables[s] = NULL;
+    }
+}
+
+void egdb_mem_remove(int s, bool is_avalanche) {
+    char packed_filename[256];
+    packedFileName(packed_filename, sizeof(packed_filename), s, is_avalanche);
+    remove(packed_filename);
+}
+
+bool egdb_mem_probe(int s, uint64_t idx, int8_t *val) {
+    if (egdb_packed_data[s]) {
+        *val = extractValue(egdb_packed_data[s], egdb_packed_width[s], idx);
+        return true;
+    } else if (egdb_tables[s]) {
+        // Layer that could not be packed
+        *val = egdb_tables[s][idx];
+        return true;
+    }
+
+    return false;
+}
+
+// A probe is a single read already, a summary would not save anything
+bool egdb_mem_probe_bound(int s, uint64_t idx, int8_t *lower, int8_t *upper) {
+    (void)s;
+    (void)idx;
+    (void)lower;
+    (void)upper;
+    return false;
+}
+
+bool egdb_mem_probe_batch(int s, const uint64_t *idx, int8_t *vals, int count) {
+    if (egdb_packed_data[s]) {
+        const uint8_t *data = egdb_packed_data[s];
+        const int width = egdb_packed_width[s];
+        for (int k = 0; k < count; k++) {
+            vals[k] = extractValue(data, width, idx[k]);
+        }
+        return true;
+    } else if (egdb_tables[s]) {
+        for (int k = 0; k < count; k++) {
+            vals[k] = egdb_tables[s][idx[k]];
+        }
+        return true;
+    }
+
+    return false;
+}
+
+uint64_t egdb_mem_get_size(int s, uint64_t size_uncompressed) {
+    if (egdb_packed_data[s]) {
+        return egdb_packed_bytes[s];
+    } else if (egdb_tables[s]) {
+        return size_uncompressed;
+    }
+
+    return 0;
+}
+
+void egdb_mem_get_cache_stats(uint64_t *hits, uint64_t *misses, uint64_t *bytes) {
+    *hits = 0;
+    *misses = 0;
+    *bytes = 0;
+}
+
+void egdb_mem_reset_cache_stats(void) {}
+
+bool egdb_mem_set_cache_size(uint64_t bytes) {
+    (void)bytes;
+    return false;
+}
+
+uint64_t egdb_mem_get_cache_size(void) {
+    return 0;
+}
@@ -0,0 +1,373 @@
+/**
+ * Copyright (c) Alexander Kurtz 2026
+ */
+
+#include "logic/solver/egdb/core.h"
+#include "logic/solver/egdb/egdb_mem.h"
+#include "logic/solver/egdb/common.h"
+#include "logic/solver/egdb/block_cache.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <zstd.h>
+#include <zdict.h>
+
+/**
+ * Zstandard backend:
+ * Layers are block layers like in the LZ4 backend. Blocks of 1 KiB are too small for zstd to find
+ * much on its own, so every layer gets a dictionary trained on a spread of its blocks, which all
+ * blocks of the layer are compressed against. That gives about half the size of LZ4HC on the same
+ * blocks.
+ *
+ * File layout of EGDB/egdb_N.zstdb (little endian):
+ *   header      magic, block size, chunk count, uncompressed size, dictionary size
+ *   dictionary  padded to 8 bytes, empty for layers too small to train one
+ * followed by the block layer sections.
+ */
+
+#define EGDB_ZSTD_MAGIC 0x42445A53 // "SZDB"
+#define EGDB_ZSTD_BLOCK_SIZE EGDB_CACHE_BLOCK_SIZE
+#define EGDB_ZSTD_HEADER_SIZE 32
+
+// Ratio levels off above 15 while compression keeps getting slower
+#define EGDB_ZSTD_LEVEL 15
+
+// At most 1/32 of the layer, trained on up to 100 times its size in sampled blocks
+#define EGDB_ZSTD_DICT_SIZE (64 * 1024)
+#define EGDB_ZSTD_DICT_MIN_SIZE 1024
+#define EGDB_ZSTD_DICT_LAYER_RATIO 32
+#define EGDB_ZSTD_DICT_SAMPLE_RATIO 100
+
+static EGDBBlockLayer egdb_layers[EGDB_MAX_STONES + 1];
+
+// Digested form of the dictionary of each layer, shared by all threads
+static ZSTD_DDict *egdb_comp_ddict[EGDB_MAX_STONES + 1] = {NULL};
+
+// Decompression contexts are not thread safe, each probing thread keeps its own
+static pthread_key_t dctxKey;
+static bool dctxKeyReady = false;
+
+typedef struct {
+    ZSTD_CCtx *cctx;
+    ZSTD_CDict *cdict;
+} ZstdEncoder;
+
+static void zstdFileName(char *buffer, size_t size, int s, bool is_avalanche) {
+    snprintf(buffer, size, "EGDB/egdb_%s%d.zstdb", is_avalanche ? "av_" : "", s);
+}
+
+static inline uint64_t dictArea(uint64_t dict_size) {
+    return (dict_size + 7) & ~(uint64_t)7;
+}
+
+static void freeDCtx(void *dctx) {
+    ZSTD_freeDCtx((ZSTD_DCtx *)dctx);
+}
+
+static ZSTD_DCtx *threadDCtx() {
+    ZSTD_DCtx *dctx = pthread_getspecific(dctxKey);
+    if (!dctx) {
+        dctx = ZSTD_createDCtx();
+        if (dctx) pthread_setspecific(dctxKey, dctx);
+    }
+    return dctx;
+}
+
+static bool decodeBlock(int s, const uint8_t *src, uint64_t bytes, int8_t *block) {
+    ZSTD_DCtx *dctx = threadDCtx();
+    if (!dctx) return false;
+
+    size_t decompressed;
+    if (egdb_comp_ddict[s]) {
+        decompressed = ZSTD_decompress_usingDDict(dctx, block, EGDB_ZSTD_BLOCK_SIZE, src, bytes, egdb_comp_ddict[s]);
+    } else {
+        decompressed = ZSTD_decompressDCtx(dctx, block, EGDB_ZSTD_BLOCK_SIZE, src, bytes);
+    }
+
+    return !ZSTD_isError(decompressed) && decompressed > 0;
+}
+
+static uint64_t encodeBlock(void *context, const int8_t *src, uint64_t bytes, uint8_t *dst, uint64_t capacity) {
+    const ZstdEncoder *encoder = context;
+
+    size_t written;
+    if (encoder->cdict) {
+        written = ZSTD_compress_usingCDict(encoder->cctx, dst, capacity, src, bytes, encoder->cdict);
+    } else {
+        written = ZSTD_compressCCtx(encoder->cctx, dst, capacity, src, bytes, EGDB_ZSTD_LEVEL);
+    }
+    return ZSTD_isError(written) ? 0 : written;
+}
+
+void egdb_mem_init(void) {
+    if (!dctxKeyReady) dctxKeyReady = pthread_key_create(&dctxKey, freeDCtx) == 0;
+    initBlockCache();
+}
+
+static void releaseCompressedLayer(int s) {
+    ZSTD_freeDDict(egdb_comp_ddict[s]);
+    egdb_comp_ddict[s] = NULL;
+    releaseBlockLayer(&egdb_layers[s], s);
+}
+
+// Digested once per layer, shared by all threads
+static bool createDDict(int s) {
+    if (egdb_layers[s].dict_size == 0) return true;
+
+    egdb_comp_ddict[s] = ZSTD_createDDict(egdb_layers[s].dict, egdb_layers[s].dict_size);
+    return egdb_comp_ddict[s] != NULL;
+}
+
+// The dictionary is used in place like offsets and payload, only the header and the total size are checked up front
+static bool mapCompressedFile(int s, uint64_t size, bool is_avalanche) {
+    char zstd_filename[256];
+    zstdFileName(zstd_filename, sizeof(zstd_filename), s, is_avalanche);
+
+    if (!dctxKeyReady) return false;
+
+    uint64_t file_size;
+    uint8_t *base = egdbMapFile(zstd_filename, EGDB_ZSTD_HEADER_SIZE, &file_size);
+    if (!base) return false;
+
+    uint32_t magic, b_size;
+    uint64_t num_chunks, uncomp_size, dict_size;
+    memcpy(&magic, base, 4);
+    memcpy(&b_size, base + 4, 4);
+    memcpy(&num_chunks, base + 8, 8);
+    memcpy(&uncomp_size, base + 16, 8);
+    memcpy(&dict_size, base + 24, 8);
+
+    EGDBBlockLayer *layer = &egdb_layers[s];
+    bool ok = magic == EGDB_ZSTD_MAGIC && b_size == EGDB_ZSTD_BLOCK_SIZE && num_chunks == blockLayerChunks(size) &&
+              uncomp_size == size && dict_size <= EGDB_ZSTD_DICT_SIZE &&
+              attachBlockFile(layer, base, file_size, EGDB_ZSTD_HEADER_SIZE + dictArea(dict_size), num_chunks);
+
+    if (ok) {
+        layer->dict = base + EGDB_ZSTD_HEADER_SIZE;
+        layer->dict_size = dict_size;
+        ok = createDDict(s);
+    }
+
+    if (!ok) {
+        memset(layer, 0, sizeof(*layer));
+        munmap(base, file_size);
+        return false;
+    }
+    return true;
+}
+
+// Trains on every n-th block, returns NULL for layers too small for a useful dictionary
+static uint8_t *trainDictionary(const int8_t *raw_data, uint64_t size, uint64_t *dict_size) {
+    *dict_size = 0;
+
+    uint64_t capacity = size / EGDB_ZSTD_DICT_LAYER_RATIO;
+    if (capacity > EGDB_ZSTD_DICT_SIZE) capacity = EGDB_ZSTD_DICT_SIZE;
+    if (capacity < EGDB_ZSTD_DICT_MIN_SIZE) return NULL;
+
+    uint64_t num_chunks = size / EGDB_ZSTD_BLOCK_SIZE;
+    uint64_t samples = capacity * EGDB_ZSTD_DICT_SAMPLE_RATIO / EGDB_ZSTD_BLOCK_SIZE;
+    if (samples > num_chunks) samples = num_chunks;
+    uint64_t stride = num_chunks / samples;
+
+    uint8_t *sample_data = malloc(samples * EGDB_ZSTD_BLOCK_SIZE);
+    size_t *sample_sizes = malloc(samples * sizeof(size_t));
+    uint8_t *dict = malloc(capacity);
+
+    if (sample_data && sample_sizes && dict) {
+        for (uint64_t i = 0; i < samples; i++) {
+            memcpy(&sample_data[i * EGDB_ZSTD_BLOCK_SIZE], &raw_data[i * stride * EGDB_ZSTD_BLOCK_SIZE], EGDB_ZSTD_BLOCK_SIZE);
+            sample_sizes[i] = EGDB_ZSTD_BLOCK_SIZE;
+        }
+
+        size_t trained = ZDICT_trainFromBuffer(dict, capacity, sample_data, sample_sizes, (unsigned)samples);
+        if (!ZDICT_isError(trained)) *dict_size = trained;
+    }
+
+    free(sample_data);
+    free(sample_sizes);
+    if (*dict_size == 0) {
+        free(dict);
+        return NULL;
+    }
+    return dict;
+}
+
+static bool compressBufferToRuntime(int s, const int8_t *raw_data, uint64_t size) {
+    EGDBBlockLayer *layer = &egdb_layers[s];
+    releaseCompressedLayer(s);
+
+    layer->dict = trainDictionary(raw_data, size, &layer->dict_size);
+
+    // Every block on its own against the dictionary of the layer
+    ZstdEncoder encoder = {ZSTD_createCCtx(), NULL};
+    if (layer->dict) encoder.cdict = ZSTD_createCDict(layer->dict, layer->dict_size, EGDB_ZSTD_LEVEL);
+
+    bool ok = encoder.cctx && (encoder.cdict || !layer->dict) && createDDict(s) &&
+              compressBlockLayer(layer, raw_data, size, ZSTD_compressBound(EGDB_ZSTD_BLOCK_SIZE), encodeBlock, &encoder);
+    ZSTD_freeCDict(encoder.cdict);
+    ZSTD_freeCCtx(encoder.cctx);
+
+    if (!ok) releaseCompressedLayer(s);
+    return ok;
+}
+
+typedef struct {
+    int stones;
+    uint64_t size;
+} CompressedFile;
+
+static bool writeCompressedContents(FILE *f, void *context) {
+    const CompressedFile *file = context;
+    const EGDBBlockLayer *layer = &egdb_layers[file->stones];
+    uint32_t magic = EGDB_ZSTD_MAGIC;
+    uint32_t b_size = EGDB_ZSTD_BLOCK_SIZE;
+    uint64_t dict_size = layer->dict_size;
+    const uint8_t padding[8] = {0};
+
+    // Write file metadata and the dictionary
+    bool ok = fwrite(&magic, 4, 1, f) == 1;
+    ok = ok && fwrite(&b_size, 4, 1, f) == 1;
+    ok = ok && fwrite(&layer->chunks, 8, 1, f) == 1;
+    ok = ok && fwrite(&file->size, 8, 1, f) == 1;
+    ok = ok && fwrite(&dict_size, 8, 1, f) == 1;
+    ok = ok && fwrite(layer->dict, 1, dict_size, f) == dict_size;
+    ok = ok && fwrite(padding, 1, dictArea(dict_size) - dict_size, f) == dictArea(dict_size) - dict_size;
+    return ok && writeBlockSections(f, layer);
+}
+
+static bool saveCompressedRuntimeToDisk(int s, uint64_t uncomp_size, bool is_avalanche) {
+    char zstd_filename[256];
+    zstdFileName(zstd_filename, sizeof(zstd_filename), s, is_avalanche);
+
+    CompressedFile file = {s, uncomp_size};
+    return writeFileReplacing(zstd_filename, writeCompressedContents, &file);
+}
+
+// The mapping gets a digested dictionary of its own, the one of the private buffers goes with them
+static void adoptCompressedFile(int s, uint64_t size, bool is_avalanche) {
+    ZSTD_DDict *ddict = egdb_comp_ddict[s];
+
+    egdb_comp_ddict[s] = NULL;
+    if (adoptBlockFile(&egdb_layers[s], s, size, is_avalanche, mapCompressedFile)) {
+        ZSTD_freeDDict(ddict);
+    } else {
+        egdb_comp_ddict[s] = ddict;
+    }
+}
+
+bool egdb_mem_load(int s, uint64_t size, bool is_avalanche) {
+    char bin_filename[256];
+    snprintf(bin_filename, sizeof(bin_filename), "EGDB/egdb_%s%d.bin", is_avalanche ? "av_" : "", s);
+
+    // Try mapping the native compressed format first, a file without block summaries is rebuilt if it can be
+    if (mapCompressedFile(s, size, is_avalanche)) {
+        if (egdb_layers[s].bounds || access(bin_filename, F_OK) != 0) return true;
+        releaseCompressedLayer(s);
+    }
+
+    // Fallback: If only raw .bin exists (or the .zstdb does not match), compress it and save to zstdb
+    if (!dctxKeyReady) return false;
+
+    uint64_t bin_size;
+    uint8_t *mapped = egdbMapFile(bin_filename, size, &bin_size);
+    if (!mapped) return false;
+
+    bool ok = compressBufferToRuntime(s, (const int8_t *)mapped, size);
+    munmap(mapped, bin_size);
+    if (ok && saveCompressedRuntimeToDisk(s, size, is_avalanche)) {
+        adoptCompressedFile(s, size, is_avalanche);
+    }
+    return ok;
+}
+
+void egdb_mem_alloc(int s, uint64_t size, bool is_avalanche) {
+    (void)is_avalanche;
+
+    releaseCompressedLayer(s);
+    egdb_tables[s] = malloc(size);
+}
+
+bool egdb_mem_save(int s, uint64_t size, bool is_avalanche) {
+    // Write out raw binary first
+    bool ok = egdbPlainSave(s, size, is_avalanche);
+
+    // Convert internal state to compressed for remaining runtime, a missing file is rebuilt from the .bin on load
+    ok = ok && dctxKeyReady && compressBufferToRuntime(s, egdb_tables[s], size);
+    if (ok && saveCompressedRuntimeToDisk(s, size, is_avalanche)) {
+        adoptCompressedFile(s, size, is_avalanche);
+    }
+
+    free(egdb_tables[s]);
+    egdb_tables[s] = NULL;
+    return ok;
+}
+
+bool egdb_mem_checkpoint(int s, uint64_t size, bool is_avalanche) {
+    return egdbPlainCheckpoint(s, size, is_avalanche);
+}
+
+bool egdb_mem_resume(int s, uint64_t size, bool is_avalanche) {
+    releaseCompressedLayer(s);
+    return egdbPlainResume(s, size, is_avalanche);
+}
+
+void egdb_mem_free_layer(int s, uint64_t size) {
+    (void)size;
+
+    releaseCompressedLayer(s);
+
+    // Plain table of a layer still in generation
+    if (egdb_tables[s]) {
+        free(egdb_tables[s]);
+        egdb_tables[s] = NULL;
+    }
+}
+
+void egdb_mem_remove(int s, bool is_avalanche) {
+    char zstd_filename[256];
+    zstdFileName(zstd_filename, sizeof(zstd_filename), s, is_avalanche);
+    remove(zstd_filename);
+}
+
+bool egdb_mem_probe(int s, uint64_t idx, int8_t *val) {
+    if (egdb_layers[s].compressed) {
+        return probeBlockLayer(&egdb_layers[s], s, idx, val, decodeBlock);
+    } else if (egdb_tables[s]) {
+        // Uncompressed cache hit
+        *val = egdb_tables[s][idx];
+        return true;
+    }
+
+    return false;
+}
+
+bool egdb_mem_probe_bound(int s, uint64_t idx, int8_t *lower, int8_t *upper) {
+    return egdb_layers[s].compressed && probeBlockLayerBound(&egdb_layers[s], idx, lower, upper);
+}
+
+bool egdb_mem_probe_batch(int s, const uint64_t *idx, int8_t *vals, int count) {
+    if (egdb_layers[s].compressed) {
+        return probeBlockLayerBatch(&egdb_layers[s], s, idx, vals, count, decodeBlock);
+    } else if (egdb_tables[s]) {
+        for (int k = 0; k < count; k++) {
+            vals[k] = egdb_tables[s][idx[k]];
+        }
+        return true;
+    }
+
+    return false;
+}
+
+uint64_t egdb_mem_get_size(int s, uint64_t size_uncompressed) {
+    if (egdb_layers[s].compressed) {
+        return blockLayerBytes(&egdb_layers[s]);
+    } else if (egdb_tables[s]) {
+        return size_uncompressed;
+    }
+
+    return 0;
+}
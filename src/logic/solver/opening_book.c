@@ -48,4 +48,8 @@ bool probeOpeningBook(const Board *board, int *bestMove, int *eval) {
         }
     }
     return false;
-}
\ No newline at end of file
+}
+
+uint64_t getOpeningBookSize() {
+    return sizeof(BOOK_HASHES) + sizeof(BOOK_MOVES) + sizeof(BOOK_EVALS);
+}
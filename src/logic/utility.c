@@ -4,6 +4,11 @@
 
 #include "logic/utility.h"
 
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#endif
+
 void quitGame() {
     exit(0);
 }
@@ -114,6 +119,64 @@ void getLogNotation(char *buffer, uint64_t value) {
     }
 }
 
+uint64_t getPhysicalMemory() {
+#ifdef _WIN32
+    MEMORYSTATUSEX status;
+    status.dwLength = sizeof(status);
+    if (!GlobalMemoryStatusEx(&status)) return 0;
+    return status.ullTotalPhys;
+#else
+    long pages = sysconf(_SC_PHYS_PAGES);
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if (pages <= 0 || pageSize <= 0) return 0;
+    return (uint64_t)pages * (uint64_t)pageSize;
+#endif
+}
+
+int getProcessorCount() {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+#endif
+}
+
+double getWallTime() {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+bool writeFileReplacing(const char *path, bool (*write)(FILE *f, void *context), void *context) {
+    char part_filename[300];
+    snprintf(part_filename, sizeof(part_filename), "%s.part", path);
+
+    FILE *f_out = fopen(part_filename, "wb");
+    if (!f_out) return false;
+    bool ok = write(f_out, context);
+    ok = ok && fflush(f_out) == 0;
+
+    // The data has to be on disk before the rename makes it the file
+#ifdef _WIN32
+    ok = ok && _commit(_fileno(f_out)) == 0;
+#else
+    ok = ok && fsync(fileno(f_out)) == 0;
+#endif
+    ok = (fclose(f_out) == 0) && ok;
+
+#ifdef _WIN32
+    if (ok) remove(path);
+#endif
+    if (!ok || rename(part_filename, path) != 0) {
+        remove(part_filename);
+        return false;
+    }
+    return true;
+}
+
 void storeBenchmarkData(const char *fileName, double *data) {
     FILE *fp = fopen(fileName, "w");
     if (!fp) {
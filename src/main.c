@@ -6,6 +6,7 @@
 
 #ifndef WEB_BUILD
 #include "user/runBenchmark.h"
+#include "user/runSweep.h"
 #endif
 
 /**
@@ -15,7 +16,18 @@ int main(int argc, char const *argv[]) {
     if (argc > 1) {
         if (strcmp(argv[1], "--benchmark") == 0) {
 #ifndef WEB_BUILD
-            runBenchmark();
+            if (argc > 2 && strcmp(argv[2], "index") == 0) {
+                runIndexBenchmark(argc > 3 ? atoi(argv[3]) : INDEX_BENCHMARK_STONES);
+            } else {
+                runBenchmark();
+            }
+#endif
+            return 0;
+        }
+
+        if (strcmp(argv[1], "--sweep") == 0) {
+#ifndef WEB_BUILD
+            runSweep(argc, argv);
 #endif
             return 0;
         }
@@ -27,7 +39,7 @@ int main(int argc, char const *argv[]) {
             return 0;
         }
 
-        printf("CMancala CLI does not support command line arguments (except --benchmark and --api). Ignoring:\n[");
+        printf("CMancala CLI does not support command line arguments (except --benchmark, --sweep and --api). Ignoring:\n[");
         for (int i = 1; i < argc; i++) {
             printf("%s", argv[i]);
             if (i < argc - 1) {
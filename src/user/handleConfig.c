@@ -4,6 +4,7 @@
 
 #include "user/handleConfig.h"
 #include "logic/solver/egdb/core.h"
+#include "logic/solver/budget.h"
 
 void renderConfigHelp() {
     renderOutput("Commands:", CONFIG_PREFIX);
@@ -18,7 +19,17 @@ void renderConfigHelp() {
     renderOutput("  clip [true|false]                : Set clip on/off, clip only computes if a move is winning or losing", CONFIG_PREFIX);
     renderOutput("  cache[number >= 17]              : Set cache size as power of two. If compression is off number needs to be >= 29", CONFIG_PREFIX);
     renderOutput("  compress [always|never|auto]     : Configure cache compression. Auto selects best mode for cache size.", CONFIG_PREFIX);
-    renderOutput("  egdb [N]                         : Load/Gen EGDB (Backend chosen at compile-time).", CONFIG_PREFIX);
+    renderOutput("  memory [GiB]                     : Share a RAM budget between book, EGDB and cache, picks the cache size (0 off)", CONFIG_PREFIX);
+    renderOutput("  solved [N|save FILE|load FILE]   : Size (power of two, 0 off) of the table keeping solved results in depth mode", CONFIG_PREFIX);
+    renderOutput("  leaf [N]                         : Size (power of two, 0 off, default off) of the small table for nodes near the horizon or with few stones", CONFIG_PREFIX);
+    renderOutput("  replace [depth|work]             : Cache replacement, work keeps entries with the largest subtrees (depth layout only)", CONFIG_PREFIX);
+    renderOutput("  cliplayout [true|false]          : Use the dense 4-byte cache layout for clip solves (cache 29 or larger)", CONFIG_PREFIX);
+    renderOutput("  unify [true|false]               : Keep the depth cache layout for solves so switching search modes keeps it warm", CONFIG_PREFIX);
+    renderOutput("  egdb [N|pack|verify]             : Load/Gen EGDB (Backend chosen at compile-time), pack writes one file, verify hashes it", CONFIG_PREFIX);
+    renderOutput("  egdb wdl [N]                     : Load/Derive win/draw/loss signs of layers 1..N at 2 bits per position (0 off)", CONFIG_PREFIX);
+    renderOutput("  threads [N]                      : Threads for EGDB generation, 0 uses every core", CONFIG_PREFIX);
+    renderOutput("  checkpoint [seconds]             : Interval between EGDB generation checkpoints, interrupted layers resume (0 off)", CONFIG_PREFIX);
+    renderOutput("  blockcache [MiB]                 : Decompressed block cache of the LZ4 and zstd EGDB backends (default 64, 0 off)", CONFIG_PREFIX);
     renderOutput("  book [true|false]                : Enable opening book", CONFIG_PREFIX);
     renderOutput("  starting [1|2]                   : Configure starting player", CONFIG_PREFIX);
     renderOutput("  player [1|2] [human|random|ai]   : Configure player", CONFIG_PREFIX);
@@ -87,6 +98,11 @@ void printConfig(Config *config) {
         renderOutput(message, CONFIG_PREFIX);
     }
 
+    if (getMemoryBudget() > 0) {
+        snprintf(message, sizeof(message), "  Memory budget: %.2f GiB", (double)getMemoryBudget() / 1073741824.0);
+        renderOutput(message, CONFIG_PREFIX);
+    }
+
     const char *compressStr = "unknown";
     switch (config->solverConfig.compressCache) {
         case ALWAYS_COMPRESS:
@@ -102,6 +118,25 @@ void printConfig(Config *config) {
     snprintf(message, sizeof(message), "  Compress: %s", compressStr);
     renderOutput(message, CONFIG_PREFIX);
 
+    if (getLeafTableSize() > 0) {
+        snprintf(message, sizeof(message), "  Leaf table size: %-12" PRIu64 "", getLeafTableSize());
+        renderOutput(message, CONFIG_PREFIX);
+    }
+
+    if (getSolvedTableSize() > 0) {
+        snprintf(message, sizeof(message), "  Solved table size: %-12" PRIu64 "", getSolvedTableSize());
+        renderOutput(message, CONFIG_PREFIX);
+    }
+
+    snprintf(message, sizeof(message), "  Replace: %s", config->solverConfig.replacePolicy == WORK_REPLACE ? "work" : "depth");
+    renderOutput(message, CONFIG_PREFIX);
+
+    snprintf(message, sizeof(message), "  Clip layout: %s", getClipLayout() ? "true" : "false");
+    renderOutput(message, CONFIG_PREFIX);
+
+    snprintf(message, sizeof(message), "  Unified cache: %s", config->solverConfig.unifiedCache ? "true" : "false");
+    renderOutput(message, CONFIG_PREFIX);
+
     snprintf(message, sizeof(message), "  Opening book: %s", config->solverConfig.useOpeningBook ? "true" : "false");
     renderOutput(message, CONFIG_PREFIX);
 
@@ -110,6 +145,24 @@ void printConfig(Config *config) {
         renderOutput(message, CONFIG_PREFIX);
     }
 
+    if (loaded_wdl_max_stones > 0) {
+        snprintf(message, sizeof(message), "  EGDB WDL Loaded: %d stones", loaded_wdl_max_stones);
+        renderOutput(message, CONFIG_PREFIX);
+    }
+
+    snprintf(message, sizeof(message), "  EGDB threads: %d%s", getEGDBThreads(), getEGDBThreads() == 0 ? " (all cores)" : "");
+    renderOutput(message, CONFIG_PREFIX);
+
+    if (getEGDBCheckpointInterval() > 0) {
+        snprintf(message, sizeof(message), "  EGDB checkpoints: every %ds", getEGDBCheckpointInterval());
+    } else {
+        snprintf(message, sizeof(message), "  EGDB checkpoints: off");
+    }
+    renderOutput(message, CONFIG_PREFIX);
+
+    snprintf(message, sizeof(message), "  EGDB block cache: %" PRIu64 " MiB", getEGDBCacheSize() >> 20);
+    renderOutput(message, CONFIG_PREFIX);
+
     snprintf(message, sizeof(message), "  Starting: %d", config->gameSettings.startColor == 1 ? 1 : 2);
     renderOutput(message, CONFIG_PREFIX);
 
@@ -160,6 +213,8 @@ void handleConfigInput(bool *requestedStart, Config *config) {
     }
 
     if (strcmp(input, "start") == 0) {
+        // Settings changed since the budget was set can change the cache layout
+        applyMemoryBudget(&config->solverConfig, false);
         *requestedStart = true;
         return;
     }
@@ -169,6 +224,36 @@ void handleConfigInput(bool *requestedStart, Config *config) {
         return;
     }
 
+    if (strcmp(input, "egdb pack") == 0) {
+        packEGDB();
+        return;
+    }
+
+    if (strcmp(input, "egdb verify") == 0) {
+        verifyEGDB();
+        return;
+    }
+
+    if (strncmp(input, "egdb wdl ", 9) == 0) {
+        int stones = atoi(input + 9);
+        bool is_avalanche = (strstr(input, "--avalanche") != NULL);
+
+        if (stones < 0 || stones > EGDB_MAX_STONES) {
+            renderOutput("Invalid WDL stones size (0 to disable)", CONFIG_PREFIX);
+            return;
+        }
+
+        if (stones == 0) {
+            freeEGDBWDL();
+            renderOutput("EGDB WDL Disabled.", CONFIG_PREFIX);
+            return;
+        }
+
+        loadEGDBWDL(stones, is_avalanche);
+        applyMemoryBudget(&config->solverConfig, true);
+        return;
+    }
+
     if (strncmp(input, "egdb ", 5) == 0) {
         int stones = atoi(input + 5);
         bool is_avalanche = (strstr(input, "--avalanche") != NULL);
@@ -189,6 +274,89 @@ void handleConfigInput(bool *requestedStart, Config *config) {
         }
 
         generateEGDB(stones, is_avalanche);
+        applyMemoryBudget(&config->solverConfig, true);
+        return;
+    }
+
+    if (strncmp(input, "threads ", 8) == 0) {
+        int threads = atoi(input + 8);
+
+        if (threads < 0 || threads > EGDB_MAX_THREADS) {
+            renderOutput("Invalid thread count", CONFIG_PREFIX);
+            return;
+        }
+
+        setEGDBThreads(threads);
+
+        char message[256];
+        if (threads == 0) {
+            snprintf(message, sizeof(message), "Updated EGDB threads to all cores (%d)", getProcessorCount());
+        } else {
+            snprintf(message, sizeof(message), "Updated EGDB threads to %d", threads);
+        }
+        renderOutput(message, CONFIG_PREFIX);
+        return;
+    }
+
+    if (strncmp(input, "checkpoint ", 11) == 0) {
+        int seconds = atoi(input + 11);
+
+        if (seconds < 0) {
+            renderOutput("Invalid checkpoint interval", CONFIG_PREFIX);
+            return;
+        }
+
+        setEGDBCheckpointInterval(seconds);
+
+        char message[256];
+        if (seconds == 0) {
+            snprintf(message, sizeof(message), "Disabled EGDB checkpoints");
+        } else {
+            snprintf(message, sizeof(message), "Updated EGDB checkpoint interval to %ds", seconds);
+        }
+        renderOutput(message, CONFIG_PREFIX);
+        return;
+    }
+
+    if (strncmp(input, "blockcache ", 11) == 0) {
+        int mib = atoi(input + 11);
+
+        if (mib < 0) {
+            renderOutput("Invalid block cache size", CONFIG_PREFIX);
+            return;
+        }
+
+        char message[256];
+        if (!setEGDBCacheSize((uint64_t)mib << 20)) {
+            snprintf(message, sizeof(message), "Block cache of %d MiB not available (needs the LZ4 or zstd backend and the memory)", mib);
+        } else if (mib == 0) {
+            snprintf(message, sizeof(message), "Disabled EGDB block cache");
+        } else {
+            snprintf(message, sizeof(message), "Updated EGDB block cache to %d MiB", mib);
+        }
+        renderOutput(message, CONFIG_PREFIX);
+
+        // The budget counts the cache
+        if (getMemoryBudget() > 0) applyMemoryBudget(&config->solverConfig, true);
+        return;
+    }
+
+    if (strncmp(input, "memory ", 7) == 0) {
+        double gib = atof(input + 7);
+
+        if (gib < 0) {
+            renderOutput("Invalid memory budget", CONFIG_PREFIX);
+            return;
+        }
+
+        setMemoryBudget((uint64_t)(gib * 1073741824.0));
+
+        if (gib == 0) {
+            renderOutput("Disabled memory budget", CONFIG_PREFIX);
+            return;
+        }
+
+        applyMemoryBudget(&config->solverConfig, true);
         return;
     }
 
@@ -228,6 +396,12 @@ void handleConfigInput(bool *requestedStart, Config *config) {
 
         setCacheSize(cacheSize);
 
+        // An explicit size replaces the planned one
+        if (getMemoryBudget() > 0) {
+            setMemoryBudget(0);
+            renderOutput("Disabled memory budget", CONFIG_PREFIX);
+        }
+
         if (cacheSize == 0) {
             renderOutput("Disabled cache", CONFIG_PREFIX);
         } else {
@@ -239,6 +413,66 @@ void handleConfigInput(bool *requestedStart, Config *config) {
         return;
     }
 
+    if (strncmp(input, "leaf ", 5) == 0) {
+        int sizePow = atoi(input + 5);
+        char message[256];
+
+        if (!setLeafTableSize(sizePow)) {
+            snprintf(message, sizeof(message), "Invalid leaf table size, use 0 or %d to %d", LEAF_TABLE_MIN_POW, LEAF_TABLE_MAX_POW);
+            renderOutput(message, CONFIG_PREFIX);
+            return;
+        }
+
+        if (sizePow == 0) {
+            renderOutput("Disabled leaf table", CONFIG_PREFIX);
+        } else {
+            snprintf(message, sizeof(message), "Updated leaf table size to %d", sizePow);
+            renderOutput(message, CONFIG_PREFIX);
+        }
+        return;
+    }
+
+    if (strncmp(input, "solved save ", 12) == 0) {
+        char message[256];
+        if (saveSolvedTable(input + 12)) {
+            snprintf(message, sizeof(message), "Saved solved table to \"%.200s\"", input + 12);
+        } else {
+            snprintf(message, sizeof(message), "Failed to save solved table to \"%.200s\"", input + 12);
+        }
+        renderOutput(message, CONFIG_PREFIX);
+        return;
+    }
+
+    if (strncmp(input, "solved load ", 12) == 0) {
+        char message[256];
+        if (loadSolvedTable(input + 12)) {
+            snprintf(message, sizeof(message), "Loaded solved table from \"%.200s\"", input + 12);
+        } else {
+            snprintf(message, sizeof(message), "Failed to load solved table from \"%.200s\" (missing, corrupt or other mode)", input + 12);
+        }
+        renderOutput(message, CONFIG_PREFIX);
+        return;
+    }
+
+    if (strncmp(input, "solved ", 7) == 0) {
+        int sizePow = atoi(input + 7);
+        char message[256];
+
+        if (!setSolvedTableSize(sizePow)) {
+            snprintf(message, sizeof(message), "Invalid solved table size, use 0 or %d to %d", SOLVED_TABLE_MIN_POW, SOLVED_TABLE_MAX_POW);
+            renderOutput(message, CONFIG_PREFIX);
+            return;
+        }
+
+        if (sizePow == 0) {
+            renderOutput("Disabled solved table", CONFIG_PREFIX);
+        } else {
+            snprintf(message, sizeof(message), "Updated solved table size to %d", sizePow);
+            renderOutput(message, CONFIG_PREFIX);
+        }
+        return;
+    }
+
     if (strncmp(input, "compress ", 9) == 0) {
         char *val = input + 9;
         CacheMode currentMode = config->solverConfig.compressCache;
@@ -277,6 +511,87 @@ void handleConfigInput(bool *requestedStart, Config *config) {
         return;
     }
 
+    if (strncmp(input, "replace ", 8) == 0) {
+        ReplacePolicy original = config->solverConfig.replacePolicy;
+
+        if (strcmp(input + 8, "depth") == 0) {
+            config->solverConfig.replacePolicy = DEPTH_REPLACE;
+            if (original == DEPTH_REPLACE) {
+                renderOutput("Replace already set to depth", CONFIG_PREFIX);
+                return;
+            }
+            renderOutput("Updated replace to depth", CONFIG_PREFIX);
+            return;
+        } else if (strcmp(input + 8, "work") == 0) {
+            config->solverConfig.replacePolicy = WORK_REPLACE;
+            if (original == WORK_REPLACE) {
+                renderOutput("Replace already set to work", CONFIG_PREFIX);
+                return;
+            }
+            renderOutput("Updated replace to work", CONFIG_PREFIX);
+            return;
+        } else {
+            char message[256];
+            snprintf(message, sizeof(message), "Invalid replace \"%.200s\"", input + 8);
+            renderOutput(message, CONFIG_PREFIX);
+            return;
+        }
+    }
+
+    if (strncmp(input, "cliplayout ", 11) == 0) {
+        bool original = getClipLayout();
+
+        if (strcmp(input + 11, "true") == 0 || strcmp(input + 11, "1") == 0) {
+            setClipLayout(true);
+            if (original) {
+                renderOutput("Clip layout already enabled", CONFIG_PREFIX);
+                return;
+            }
+            renderOutput("Enabled clip layout", CONFIG_PREFIX);
+            return;
+        } else if (strcmp(input + 11, "false") == 0 || strcmp(input + 11, "0") == 0) {
+            setClipLayout(false);
+            if (!original) {
+                renderOutput("Clip layout already disabled", CONFIG_PREFIX);
+                return;
+            }
+            renderOutput("Disabled clip layout", CONFIG_PREFIX);
+            return;
+        } else {
+            char message[256];
+            snprintf(message, sizeof(message), "Invalid cliplayout \"%.200s\"", input + 11);
+            renderOutput(message, CONFIG_PREFIX);
+            return;
+        }
+    }
+
+    if (strncmp(input, "unify ", 6) == 0) {
+        bool original = config->solverConfig.unifiedCache;
+
+        if (strcmp(input + 6, "true") == 0 || strcmp(input + 6, "1") == 0) {
+            config->solverConfig.unifiedCache = true;
+            if (original) {
+                renderOutput("Unified cache already enabled", CONFIG_PREFIX);
+                return;
+            }
+            renderOutput("Enabled unified cache", CONFIG_PREFIX);
+            return;
+        } else if (strcmp(input + 6, "false") == 0 || strcmp(input + 6, "0") == 0) {
+            config->solverConfig.unifiedCache = false;
+            if (!original) {
+                renderOutput("Unified cache already disabled", CONFIG_PREFIX);
+                return;
+            }
+            renderOutput("Disabled unified cache", CONFIG_PREFIX);
+            return;
+        } else {
+            char message[256];
+            snprintf(message, sizeof(message), "Invalid unify \"%.200s\"", input + 6);
+            renderOutput(message, CONFIG_PREFIX);
+            return;
+        }
+    }
+
     if (strncmp(input, "clip ", 5) == 0) {
         bool originalClip = config->solverConfig.clip;
 
@@ -5,6 +5,7 @@
 #include "user/interface.h"
 #include "logic/solver/egdb/core.h"
 #include "logic/solver/cache.h"
+#include "logic/solver/budget.h"
 #include "logic/utility.h"
 
 void runApiMode(int argc, char const *argv[]) {
@@ -14,6 +15,8 @@ void runApiMode(int argc, char const *argv[]) {
         .timeLimit = 0.0,
         .clip = false,
         .compressCache = AUTO,
+        .unifiedCache = true,
+        .replacePolicy = DEPTH_REPLACE,
         .progressBar = false,
         .useOpeningBook = false};
 
@@ -25,6 +28,8 @@ void runApiMode(int argc, char const *argv[]) {
             egdb_stones = atoi(argv[++i]);
         } else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
             setCacheSize(atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--memory") == 0 && i + 1 < argc) {
+            setMemoryBudget((uint64_t)(atof(argv[++i]) * 1073741824.0));
         } else if (strcmp(argv[i], "--mode") == 0 && i + 1 < argc) {
             if (strcmp(argv[++i], "avalanche") == 0) avalanche = true;
         }
@@ -37,6 +42,8 @@ void runApiMode(int argc, char const *argv[]) {
         generateEGDB(egdb_stones, avalanche);
     }
 
+    applyMemoryBudget(&config, false);
+
     char line[1024];
     while (fgets(line, sizeof(line), stdin)) {
         trimSpaces(line);
@@ -141,6 +148,8 @@ void startInterface() {
         .timeLimit = 5.0,
         .clip = false,
         .compressCache = AUTO,
+        .unifiedCache = true,
+        .replacePolicy = DEPTH_REPLACE,
         .progressBar = true,
         .useOpeningBook = false};
 
@@ -9,6 +9,7 @@ static const SolverConfig *progressConfig = NULL;
 static const char *progressPrefix = NULL;
 static const int BAR_WIDTH = 40;
 static bool progressFirstUpdate;
+static double egdbProgressStartTime;
 
 // --- Binary Search Progress Tracking ---
 static int binaryCurrentStep = 0;
@@ -169,13 +170,14 @@ void finishProgress() {
 }
 
 void startEGDBProgress() {
-    progressStartTime = clock();
+    egdbProgressStartTime = getWallTime();
     progressFirstUpdate = true;
     progressPrefix = CONFIG_PREFIX;
 }
 
 void updateEGDBProgress(int stones, uint64_t current, uint64_t total) {
-    double elapsed = (double)(clock() - progressStartTime) / CLOCKS_PER_SEC;
+    // Wall time, generation may run on several threads
+    double elapsed = getWallTime() - egdbProgressStartTime;
     double percentage = (total > 0) ? (double)current / (double)total : 0.0;
 
     if (percentage > 1.0) percentage = 1.0;
@@ -432,6 +434,32 @@ void renderCacheOverview(const CacheStats *stats, bool showFrag, bool showStoneD
         renderOutput(message, CHEAT_PREFIX);
     }
 
+    if (stats->rehashed > 0 || stats->rehashDropped > 0) {
+        getLogNotation(logBuffer, stats->rehashed);
+        snprintf(message, sizeof(message), "  Rehashed:   %-12" PRIu64 " %s (%" PRIu64 " dropped)", stats->rehashed, logBuffer, stats->rehashDropped);
+        renderOutput(message, CHEAT_PREFIX);
+    }
+
+    if (stats->solvedTableSize > 0) {
+        const double solvedFillPct = (double)stats->solvedTableEntries / (double)stats->solvedTableSize * 100.0;
+        getLogNotation(logBuffer, stats->solvedTableSize);
+        snprintf(message, sizeof(message), "  Solved tbl: %-12" PRIu64 " %s (%.2f%% Used)", stats->solvedTableSize, logBuffer, solvedFillPct);
+        renderOutput(message, CHEAT_PREFIX);
+        getLogNotation(logBuffer, stats->solvedTableHits);
+        snprintf(message, sizeof(message), "    Hits:     %-12" PRIu64 " %s (%" PRIu64 " spilled)", stats->solvedTableHits, logBuffer, stats->solvedTableSpills);
+        renderOutput(message, CHEAT_PREFIX);
+    }
+
+    if (stats->leafTableSize > 0) {
+        const double leafFillPct = (double)stats->leafTableEntries / (double)stats->leafTableSize * 100.0;
+        getLogNotation(logBuffer, stats->leafTableSize);
+        snprintf(message, sizeof(message), "  Leaf tbl:   %-12" PRIu64 " %s (%.2f%% Used)", stats->leafTableSize, logBuffer, leafFillPct);
+        renderOutput(message, CHEAT_PREFIX);
+        getLogNotation(logBuffer, stats->leafTableHits);
+        snprintf(message, sizeof(message), "    Hits:     %-12" PRIu64 " %s (%" PRIu64 " stores)", stats->leafTableHits, logBuffer, stats->leafTableStores);
+        renderOutput(message, CHEAT_PREFIX);
+    }
+
     if (stats->setEntries > 0) {
         snprintf(message, sizeof(message), "  Bounds:     E %.2f%% | L %.2f%% | U %.2f%%",
                  (double)stats->exactCount / (double)stats->setEntries * 100.0,
@@ -440,6 +468,13 @@ void renderCacheOverview(const CacheStats *stats, bool showFrag, bool showStoneD
     } else {
         snprintf(message, sizeof(message), "  Bounds:     E 0.00%% | L 0.00%% | U 0.00%%");
     }
+    if (!stats->hasDepth) {
+        // Entries holding a finite lower and upper bound
+        char window[32];
+        const double windowPct = (stats->setEntries > 0) ? (double)stats->windowCount / (double)stats->setEntries * 100.0 : 0.0;
+        snprintf(window, sizeof(window), " | W %.2f%%", windowPct);
+        strncat(message, window, sizeof(message) - strlen(message) - 1);
+    }
     renderOutput(message, CHEAT_PREFIX);
 
     if (showStoneDist && stats->setEntries > 0) {
@@ -500,7 +535,11 @@ void renderEGDBOverview() {
 
     getEGDBStats(&egdbSize, &egdbHits, &egdbMin, &egdbMax);
 
-    if (egdbMax <= 0) {
+    uint64_t wdlHits, wdlSize;
+    int wdlMax;
+    getEGDBWDLStats(&wdlSize, &wdlHits, &wdlMax);
+
+    if (egdbMax <= 0 && wdlMax <= 0) {
         renderOutput("  EGDB not loaded or disabled", CHEAT_PREFIX);
         return;
     }
@@ -508,6 +547,15 @@ void renderEGDBOverview() {
     char message[256];
     char logBuffer[32];
 
+    if (wdlMax > 0) {
+        getLogNotation(logBuffer, wdlHits);
+        snprintf(message, sizeof(message), "  EGDB WDL: 1 to %d stones, %.2f MB, %" PRIu64 " hits %s",
+                 wdlMax, (double)wdlSize / 1048576.0, wdlHits, logBuffer);
+        renderOutput(message, CHEAT_PREFIX);
+    }
+
+    if (egdbMax <= 0) return;
+
     snprintf(message, sizeof(message), "  EGDB Status: Loaded (%d to %d stones)", egdbMin, egdbMax);
     renderOutput(message, CHEAT_PREFIX);
 
@@ -525,4 +573,21 @@ void renderEGDBOverview() {
     getLogNotation(logBuffer, egdbHits);
     snprintf(message, sizeof(message), "    Hits:     %-12" PRIu64 " %s", egdbHits, logBuffer);
     renderOutput(message, CHEAT_PREFIX);
+
+    uint64_t boundHits = getEGDBBoundHits();
+    if (boundHits > 0) {
+        getLogNotation(logBuffer, boundHits);
+        snprintf(message, sizeof(message), "    Bounds:   %-12" PRIu64 " %s", boundHits, logBuffer);
+        renderOutput(message, CHEAT_PREFIX);
+    }
+
+    uint64_t blockHits, blockMisses, blockBytes;
+    getEGDBCacheStats(&blockHits, &blockMisses, &blockBytes);
+    if (blockBytes == 0) return;
+
+    uint64_t blockProbes = blockHits + blockMisses;
+    snprintf(message, sizeof(message), "    Blocks:   %.2f MB cache, %" PRIu64 " hits / %" PRIu64 " misses (%.1f%%)",
+             (double)blockBytes / 1048576.0, blockHits, blockMisses,
+             blockProbes > 0 ? 100.0 * (double)blockHits / (double)blockProbes : 0.0);
+    renderOutput(message, CHEAT_PREFIX);
 }
@@ -39,6 +39,8 @@ static void runTest(
         .timeLimit = 0,
         .progressBar = false,
         .compressCache = compress,
+        .unifiedCache = false, // Every layout should be exercised
+        .replacePolicy = DEPTH_REPLACE,
         .clip = false};
 
     // Print Config Details
@@ -95,12 +97,9 @@ void runBenchmark() {
     printf("----------------------------------------------------------------\n");
     printf("Generating EGDB for PGO Coverage...\n");
 
+    // A container or backend file left behind would be mapped instead of generating
     const int egdb_size = 18;
-    for (int s = 1; s <= egdb_size; s++) {
-        char filename[256];
-        snprintf(filename, sizeof(filename), "EGDB/egdb_%d.bin", s);
-        remove(filename);
-    }
+    removeEGDBFiles(egdb_size, false);
 
     generateEGDB(egdb_size, false);
     setStoneCount(2 * 12);
@@ -108,6 +107,8 @@ void runBenchmark() {
     // 5. GLOBAL + EGDB
     runTest(&context, 2, 0, ALWAYS_COMPRESS, 0, GLOBAL_SOLVER, "EGDB_CLASSIC (Global 2 Stones)", CLASSIC_MOVE);
 
+    // Loads the layers just written
+    freeEGDB();
     generateEGDB(egdb_size, false);
     setStoneCount(4 * 12);
 
@@ -119,3 +120,8 @@ void runBenchmark() {
     printf("----------------------------------------------------------------\n");
     printf("Benchmark Complete.\n");
 }
+
+void runIndexBenchmark(int stones) {
+    printf("Starting EGDB Index Benchmark...\n");
+    benchmarkEGDBIndex(stones, INDEX_BENCHMARK_SAMPLES);
+}
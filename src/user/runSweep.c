@@ -0,0 +1,193 @@
+/**
+ * Copyright (c) Alexander Kurtz 2026
+ */
+
+#include "user/runSweep.h"
+
+#define SWEEP_WAY_CONFIGS 3
+#define SWEEP_SLOT_EMPTY 0
+#define SWEEP_SLOT_USED 0x80000000u
+
+static const int sweepWays[SWEEP_WAY_CONFIGS] = {1, 2, 4};
+static const int sweepWayBits[SWEEP_WAY_CONFIGS] = {0, 1, 2};
+
+typedef struct {
+    int sizePow;
+    int ways;
+    int indexBits;
+    uint64_t bucketMask;
+    uint32_t *slots;
+
+    uint64_t probes;
+    uint64_t hits;
+    uint64_t stores;
+    uint64_t evictions;
+} SweepTable;
+
+static SweepTable *sweepTables = NULL;
+static int sweepTableCount = 0;
+
+static double currentTimeMs() {
+    return (double)clock() * 1000.0 / CLOCKS_PER_SEC;
+}
+
+static bool initSweepTables(int minPow, int maxPow) {
+    sweepTableCount = (maxPow - minPow + 1) * SWEEP_WAY_CONFIGS;
+    sweepTables = calloc(sweepTableCount, sizeof(SweepTable));
+    if (!sweepTables) return false;
+
+    int t = 0;
+    for (int pow = minPow; pow <= maxPow; pow++) {
+        for (int w = 0; w < SWEEP_WAY_CONFIGS; w++) {
+            SweepTable *table = &sweepTables[t++];
+
+            // Same entry count as the real table, grouped into buckets of the given ways
+            table->sizePow = pow;
+            table->ways = sweepWays[w];
+            table->indexBits = pow - sweepWayBits[w];
+            table->bucketMask = ((uint64_t)1 << table->indexBits) - 1;
+            table->slots = calloc((size_t)1 << pow, sizeof(uint32_t));
+            if (!table->slots) return false;
+        }
+    }
+
+    return true;
+}
+
+static void freeSweepTables() {
+    for (int t = 0; t < sweepTableCount; t++) {
+        free(sweepTables[t].slots);
+    }
+    free(sweepTables);
+    sweepTables = NULL;
+    sweepTableCount = 0;
+}
+
+static void traceSweep(uint64_t key, bool store) {
+    for (int t = 0; t < sweepTableCount; t++) {
+        SweepTable *table = &sweepTables[t];
+        uint32_t *b = &table->slots[(key & table->bucketMask) * table->ways];
+        uint32_t tag = (uint32_t)(key >> table->indexBits) | SWEEP_SLOT_USED;
+
+        int found = -1;
+        for (int i = 0; i < table->ways; i++) {
+            if (b[i] == tag) {
+                found = i;
+                break;
+            }
+        }
+
+        if (store) {
+            table->stores++;
+        } else {
+            table->probes++;
+            if (found >= 0) table->hits++;
+        }
+
+        // Misses only allocate on stores, like the real table
+        if (found < 0 && !store) continue;
+
+        // Most recently used first, a new entry pushes out the last one
+        int last = found;
+        if (found < 0) {
+            last = table->ways - 1;
+            if (b[last] != SWEEP_SLOT_EMPTY) table->evictions++;
+        }
+        for (int i = last; i > 0; i--) {
+            b[i] = b[i - 1];
+        }
+        b[0] = tag;
+    }
+}
+
+static uint64_t countSweepEntries(const SweepTable *table) {
+    uint64_t entries = 0;
+    for (uint64_t i = 0; i < ((uint64_t)1 << table->sizePow); i++) {
+        if (table->slots[i] != SWEEP_SLOT_EMPTY) entries++;
+    }
+    return entries;
+}
+
+void runSweep(int argc, char const *argv[]) {
+    int stones = (argc > 2) ? atoi(argv[2]) : SWEEP_DEFAULT_STONES;
+    int minPow = (argc > 3) ? atoi(argv[3]) : SWEEP_DEFAULT_MIN_POW;
+    int maxPow = (argc > 4) ? atoi(argv[4]) : SWEEP_DEFAULT_MAX_POW;
+    const char *fileName = (argc > 5) ? argv[5] : SWEEP_DEFAULT_FILE;
+
+    if (stones <= 0 || minPow < MIN_CACHE_SIZE || maxPow < minPow || maxPow > SWEEP_MAX_POW) {
+        printf("Usage: --sweep [stones > 0] [minPow >= %d] [maxPow <= %d] [file]\n", MIN_CACHE_SIZE, SWEEP_MAX_POW);
+        return;
+    }
+
+    if (!initSweepTables(minPow, maxPow)) {
+        printf("Not enough memory for the simulated tables\n");
+        freeSweepTables();
+        return;
+    }
+
+    printf("Sweeping %d stones, cache 2^%d to 2^%d (ways 1, 2, 4)...\n", stones, minPow, maxPow);
+
+    setMoveFunction(CLASSIC_MOVE);
+    setStoneCount(stones * 12);
+    setCacheSize(maxPow);
+    invalidateCache();
+
+    Board board = {0};
+    Board lastBoard = {0};
+    Context context = {0};
+    context.board = &board;
+    context.lastBoard = &lastBoard;
+
+    configBoard(&board, stones);
+    board.color = 1;
+
+    SolverConfig config = {
+        .solver = LOCAL_SOLVER,
+        .depth = 0,
+        .timeLimit = 0,
+        .clip = false,
+        .compressCache = AUTO,
+        .unifiedCache = false,
+        .replacePolicy = DEPTH_REPLACE,
+        .progressBar = false,
+        .useOpeningBook = false};
+
+    // Leaf table would hide part of the stream from the sizes being compared
+    setLeafTableSize(0);
+
+    setCacheTraceHook(traceSweep);
+    double start = currentTimeMs();
+    aspirationRoot(&context, &config);
+    double elapsed = currentTimeMs() - start;
+    setCacheTraceHook(NULL);
+
+    printf("Reference solve (2^%d): %.2f ms | Eval: %d | Nodes: %" PRIu64 "\n",
+           maxPow, elapsed, context.metadata.lastEvaluation, context.metadata.lastNodes);
+
+    FILE *fp = fopen(fileName, "w");
+    if (!fp) {
+        printf("Error writing to file %s\n", fileName);
+        freeSweepTables();
+        return;
+    }
+
+    // CSV Header
+    fprintf(fp, "Stones,SizePow,Ways,Probes,Hits,HitRate,Stores,Evictions,Fill\n");
+
+    for (int t = 0; t < sweepTableCount; t++) {
+        const SweepTable *table = &sweepTables[t];
+        double hitRate = table->probes ? (double)table->hits / (double)table->probes : 0.0;
+        double fill = (double)countSweepEntries(table) / (double)((uint64_t)1 << table->sizePow);
+
+        fprintf(fp, "%d,%d,%d,%" PRIu64 ",%" PRIu64 ",%.6f,%" PRIu64 ",%" PRIu64 ",%.6f\n",
+                stones, table->sizePow, table->ways, table->probes, table->hits, hitRate,
+                table->stores, table->evictions, fill);
+
+        printf("  2^%-2d %d-way: hit rate %6.2f%% | evictions %" PRIu64 "\n",
+               table->sizePow, table->ways, hitRate * 100.0, table->evictions);
+    }
+
+    fclose(fp);
+    freeSweepTables();
+    printf("Stored sweep in %s\n", fileName);
+}
@@ -428,6 +428,8 @@ static void init_game_with_config(int stones, int distribution, int moveFunc, do
         .timeLimit = timeLimit,
         .clip = false,
         .compressCache = AUTO,
+        .unifiedCache = true,
+        .replacePolicy = DEPTH_REPLACE,
         .progressBar = false,
         .useOpeningBook = (useBook != 0)};
     int actualSeed = seedInput;